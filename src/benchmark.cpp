@@ -0,0 +1,248 @@
+#include "benchmark.h"
+#include "clustering.h"
+#include "kdtree.h"
+#include "morton_tree.h"
+#include "multiprocess_dbscan.h"
+#include "obj_loader.h"
+#include "parallel.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    float seconds_since(std::chrono::high_resolution_clock::time_point start)
+    {
+        return std::chrono::duration<float>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    int count_mismatches(const std::vector<int> &a, const std::vector<int> &b)
+    {
+        if (a.size() != b.size())
+            return -1;
+        int mismatches = 0;
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            if (a[i] != b[i])
+                mismatches++;
+        }
+        return mismatches;
+    }
+
+    // 반경 탐색 인덱스: KD-Tree와 Morton 트리(LBVH)의 구축/탐색 시간, 이웃 집합 비교
+    // 쿼리는 최대 100000개 점을 고르게 골라 사용
+    void benchmark_indexes(const std::vector<Point3D> &points, KDTree &tree, float kd_build_time, float radius)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        MortonTree morton(points);
+        float morton_build_time = seconds_since(start);
+
+        int n = points.size();
+        int stride = std::max(1, n / 100000);
+        std::vector<int> queries;
+        for (int i = 0; i < n; i += stride)
+        {
+            queries.push_back(i);
+        }
+        int count = queries.size();
+
+        std::vector<std::vector<int>> kd_results(count), morton_results(count);
+        start = std::chrono::high_resolution_clock::now();
+        parallel_for(0, count, 256, [&](int begin, int end, int)
+                     {
+                         for (int q = begin; q < end; q++)
+                         {
+                             kd_results[q] = tree.find_radius(points[queries[q]], radius);
+                         }
+                     });
+        float kd_query_time = seconds_since(start);
+
+        start = std::chrono::high_resolution_clock::now();
+        parallel_for(0, count, 256, [&](int begin, int end, int)
+                     {
+                         for (int q = begin; q < end; q++)
+                         {
+                             morton_results[q] = morton.find_radius(points[queries[q]], radius);
+                         }
+                     });
+        float morton_query_time = seconds_since(start);
+
+        // 결과 순서는 인덱스마다 다르므로 정렬해서 비교
+        int mismatches = 0;
+        for (int q = 0; q < count; q++)
+        {
+            std::sort(kd_results[q].begin(), kd_results[q].end());
+            std::sort(morton_results[q].begin(), morton_results[q].end());
+            if (kd_results[q] != morton_results[q])
+                mismatches++;
+        }
+
+        std::cout << "\n[반경 탐색 인덱스] 쿼리 " << count << "개, 반경 " << radius << std::endl;
+        std::cout << "  KD-Tree    : 구축 " << kd_build_time << " s, 탐색 " << kd_query_time << " s" << std::endl;
+        std::cout << "  Morton 트리: 구축 " << morton_build_time << " s, 탐색 " << morton_query_time
+                  << " s, KD-Tree와 다른 이웃 집합 " << mismatches << "개" << std::endl;
+    }
+
+    // 패킷 반경 탐색: 한 점씩 find_radius와 KDTREE_PACKET_SIZE개 묶음 탐색(이웃 목록 / 개수만) 시간, 이웃 수 합 비교
+    // 쿼리는 트리 순서에서 패킷 단위로 고르게 골라 최대 약 1000000개 (패킷 안의 점은 공간적으로 인접)
+    void benchmark_packets(const std::vector<Point3D> &points, KDTree &tree, float radius)
+    {
+        std::vector<int> order = tree.spatial_order();
+        int packets = (order.size() + KDTREE_PACKET_SIZE - 1) / KDTREE_PACKET_SIZE;
+        int packet_stride = std::max(1, packets / (1000000 / KDTREE_PACKET_SIZE));
+        std::vector<Point3D> queries;
+        for (int b = 0; b < packets; b += packet_stride)
+        {
+            int end = std::min((int)order.size(), (b + 1) * KDTREE_PACKET_SIZE);
+            for (int j = b * KDTREE_PACKET_SIZE; j < end; j++)
+            {
+                queries.push_back(points[order[j]]);
+            }
+        }
+        int count = queries.size();
+
+        // 스레드별 이웃 수 합 (같은 쿼리면 세 방식 모두 같아야 함)
+        std::vector<long long> sums(worker_count(), 0);
+        auto total = [&]()
+        {
+            long long sum = 0;
+            for (long long &s : sums)
+            {
+                sum += s;
+                s = 0;
+            }
+            return sum;
+        };
+
+        auto start = std::chrono::high_resolution_clock::now();
+        parallel_for(0, count, 4096, [&](int begin, int end, int thread_id)
+                     {
+                         for (int q = begin; q < end; q++)
+                         {
+                             sums[thread_id] += tree.find_radius(queries[q], radius).size();
+                         }
+                     });
+        float single_time = seconds_since(start);
+        long long single_sum = total();
+
+        start = std::chrono::high_resolution_clock::now();
+        parallel_for(0, count, 4096, [&](int begin, int end, int thread_id)
+                     {
+                         std::vector<int> neighbors[KDTREE_PACKET_SIZE];
+                         for (int q = begin; q < end; q += KDTREE_PACKET_SIZE)
+                         {
+                             int n = std::min(KDTREE_PACKET_SIZE, end - q);
+                             for (int k = 0; k < n; k++)
+                             {
+                                 neighbors[k].clear();
+                             }
+                             tree.find_radius_packet(&queries[q], n, radius, neighbors);
+                             for (int k = 0; k < n; k++)
+                             {
+                                 sums[thread_id] += neighbors[k].size();
+                             }
+                         }
+                     });
+        float packet_time = seconds_since(start);
+        long long packet_sum = total();
+
+        start = std::chrono::high_resolution_clock::now();
+        parallel_for(0, count, 4096, [&](int begin, int end, int thread_id)
+                     {
+                         int counts[KDTREE_PACKET_SIZE];
+                         for (int q = begin; q < end; q += KDTREE_PACKET_SIZE)
+                         {
+                             int n = std::min(KDTREE_PACKET_SIZE, end - q);
+                             tree.count_radius_packet(&queries[q], n, radius, counts);
+                             for (int k = 0; k < n; k++)
+                             {
+                                 sums[thread_id] += counts[k];
+                             }
+                         }
+                     });
+        float count_time = seconds_since(start);
+        long long count_sum = total();
+
+        std::cout << "\n[패킷 반경 탐색] 쿼리 " << count << "개, 반경 " << radius << ", 패킷 " << KDTREE_PACKET_SIZE
+                  << "개" << std::endl;
+        std::cout << "  find_radius (한 점씩)  : " << single_time << " s, 이웃 수 합 " << single_sum << std::endl;
+        std::cout << "  find_radius_packet     : " << packet_time << " s, 이웃 수 합 " << packet_sum << std::endl;
+        std::cout << "  count_radius_packet    : " << count_time << " s, 이웃 수 합 " << count_sum << std::endl;
+    }
+
+    // 다중 프로세스 DBSCAN: 작업 프로세스 수별 시간 (기준 = 같은 점의 격자 DBSCAN)
+    void benchmark_multiprocess(const std::vector<Point3D> &points, float epsilon, int min_points,
+                                int max_workers, const std::vector<int> &reference)
+    {
+        std::cout << "\n[다중 프로세스 DBSCAN] 코어 " << worker_count() << "개를 작업 프로세스끼리 나눠 사용" << std::endl;
+        for (int workers = 1; workers <= max_workers; workers *= 2)
+        {
+            MultiprocessDbscanStats stats;
+            auto start = std::chrono::high_resolution_clock::now();
+            std::vector<int> labels = dbscan_clustering_multiprocess(points, epsilon, min_points, workers, &stats);
+            float total = seconds_since(start);
+
+            if (labels.empty())
+            {
+                std::cout << "  작업 프로세스 " << workers << "개: 실패" << std::endl;
+                break;
+            }
+            std::cout << "  작업 프로세스 " << workers << "개: " << total << " s (분할 " << stats.partition_time
+                      << ", 코어 " << stats.core_time << ", 병합 " << stats.merge_time << ", 경계점 "
+                      << stats.border_time << "), 격자와 다른 레이블 " << count_mismatches(labels, reference)
+                      << "개" << std::endl;
+        }
+    }
+}
+
+int run_benchmark(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        std::cerr << "사용법: " << argv[0] << " " << BENCHMARK_ARG
+                  << " <OBJ 경로> [Epsilon] [MinPts] [최대 작업 프로세스 수]" << std::endl;
+        return 1;
+    }
+
+    std::string path = argv[2];
+    float epsilon = argc > 3 ? std::atof(argv[3]) : 0.05f;
+    int min_points = argc > 4 ? std::atoi(argv[4]) : 10;
+    int max_workers = argc > 5 ? std::atoi(argv[5]) : worker_count();
+
+    OBJMesh *mesh = load_obj(path);
+    if (!mesh)
+    {
+        std::cerr << "OBJ 로드 실패: " << path << std::endl;
+        return 1;
+    }
+
+    std::vector<Point3D> points;
+    points.reserve(mesh->vertices.size());
+    for (const auto &v : mesh->vertices)
+    {
+        points.push_back(Point3D(v.x, v.y, v.z));
+    }
+    free_mesh(mesh);
+
+    std::cout << "\n=== 벤치마크: " << path << " (" << points.size() << "개 점, Epsilon " << epsilon
+              << ", MinPts " << min_points << ") ===" << std::endl;
+
+    // 기준: KD-Tree 구축 + 격자 DBSCAN
+    auto start = std::chrono::high_resolution_clock::now();
+    KDTree tree(points, true);
+    tree.build_all();
+    float build_time = seconds_since(start);
+
+    start = std::chrono::high_resolution_clock::now();
+    std::vector<int> reference = dbscan_clustering_grid(points, tree, epsilon, min_points);
+    float grid_time = seconds_since(start);
+    std::cout << "\n[격자 DBSCAN] KD-Tree 구축 " << build_time << " s, DBSCAN " << grid_time << " s" << std::endl;
+
+    benchmark_packets(points, tree, epsilon);
+    benchmark_indexes(points, tree, build_time, epsilon);
+    benchmark_multiprocess(points, epsilon, min_points, std::max(1, max_workers), reference);
+    return 0;
+}
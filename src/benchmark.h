@@ -0,0 +1,15 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+// 명령줄 벤치마크 실행 인자 (창을 만들지 않음)
+// program --benchmark <OBJ 경로> [Epsilon] [MinPts] [최대 작업 프로세스 수]
+const char *const BENCHMARK_ARG = "--benchmark";
+
+// 벤치마크 진입점 (main에서 argv[1] == BENCHMARK_ARG일 때 호출, 종료 코드 반환)
+// 1. Epsilon 반경 탐색을 한 점씩(find_radius) / 패킷(find_radius_packet, count_radius_packet)으로 실행한 시간
+// 2. KD-Tree와 Morton 트리의 구축 시간, Epsilon 반경 탐색 시간과 이웃 집합 일치 여부
+// 3. 격자 DBSCAN을 기준으로 다중 프로세스 DBSCAN을 작업 프로세스 1, 2, 4, ...개로 실행해
+//    단계별 시간과 레이블 불일치 수
+int run_benchmark(int argc, char **argv);
+
+#endif // BENCHMARK_H
@@ -1,62 +1,362 @@
 #include "clustering.h"
+#include "parallel.h"
+#include "normals.h"
 #include <map>
+#include <unordered_map>
 #include <queue>
 #include <iostream>
 #include <fstream>
 #include <cmath>
 #include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
 
-std::vector<ClusterInfo> analyze_clusters(
-    const std::vector<Point3D> &points,
-    const std::vector<int> &labels)
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CLUSTERING_USE_SSE2
+#endif
+
+// 클러스터 누적값 (좌표는 첫 점 기준으로 옮겨 분산 계산의 자릿수 손실을 줄임)
+struct ClusterMoments
+{
+    long long count = 0;
+    double sx = 0, sy = 0, sz = 0;
+    double sxx = 0, sxy = 0, sxz = 0, syy = 0, syz = 0, szz = 0;
+    float lo[3] = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                   std::numeric_limits<float>::max()};
+    float hi[3] = {std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(),
+                   std::numeric_limits<float>::lowest()};
+};
+
+// 클러스터별 두 번째 패스 결과 (중심 기준 주축 투영 최소/최대, 최대 거리 제곱)
+struct alignas(16) ClusterExtent
+{
+    float lo[4];
+    float hi[4];
+    float max_d2;
+};
+
+// u를 unit에 직교화해 정규화 (unit과 평행하면 unit에서 가장 작은 성분의 좌표축 사용)
+static void orthonormalize(double u[3], const double unit[3])
+{
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        double dot = u[0] * unit[0] + u[1] * unit[1] + u[2] * unit[2];
+        u[0] -= dot * unit[0];
+        u[1] -= dot * unit[1];
+        u[2] -= dot * unit[2];
+        double length = std::sqrt(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+        if (length > 1e-6)
+        {
+            u[0] /= length;
+            u[1] /= length;
+            u[2] /= length;
+            return;
+        }
+
+        int least = 0;
+        for (int d = 1; d < 3; d++)
+        {
+            if (std::fabs(unit[d]) < std::fabs(unit[least]))
+                least = d;
+        }
+        u[0] = u[1] = u[2] = 0;
+        u[least] = 1;
+    }
+}
+
+// 공분산 주축: 고유값 내림차순 + 앞 두 고유벡터 (normals.h의 닫힌 해 사용)
+// m: xx, xy, xz, yy, yz, zz / vectors[k] = k번째 고유벡터 (세 번째 축은 호출한 쪽에서 외적)
+static void principal_axes(const double m[6], double values[3], double vectors[2][3])
 {
-    std::map<int, std::vector<int>> cluster_map;
+    double ascending[3];
+    symmetric_eigenvalues(m, ascending);
+    values[0] = ascending[2];
+    values[1] = ascending[1];
+    values[2] = ascending[0];
 
-    // 클러스터별로 점 분류
-    for (size_t i = 0; i < labels.size(); i++)
+    double *v0 = vectors[0], *v1 = vectors[1];
+    v0[0] = 1, v0[1] = 0, v0[2] = 0;
+    v1[0] = 0, v1[1] = 1, v1[2] = 0;
+
+    // 중복 고유값의 고유벡터는 정해지지 않으므로 간격이 큰 쪽의 단일 고유값에서 먼저 구하고
+    // 나머지는 그 벡터에 직교화 (중복 고유공간 = 그 벡터의 수직 평면)
+    if (values[0] - values[1] >= values[1] - values[2])
+    {
+        if (!symmetric_eigenvector(m, values[0], v0))
+            return; // 0 행렬 (점 하나): 좌표축 그대로
+        if (!symmetric_eigenvector(m, values[1], v1))
+            v1[0] = 0, v1[1] = 1, v1[2] = 0;
+        orthonormalize(v1, v0);
+    }
+    else
     {
-        cluster_map[labels[i]].push_back(i);
+        double v2[3];
+        if (!symmetric_eigenvector(m, values[2], v2))
+            return;
+        if (!symmetric_eigenvector(m, values[0], v0))
+            v0[0] = 1, v0[1] = 0, v0[2] = 0;
+        orthonormalize(v0, v2);
+        // v1 = v2 x v0 (오른손 좌표계로 v0 x v1 = v2)
+        v1[0] = v2[1] * v0[2] - v2[2] * v0[1];
+        v1[1] = v2[2] * v0[0] - v2[0] * v0[2];
+        v1[2] = v2[0] * v0[1] - v2[1] * v0[0];
     }
+}
 
+std::vector<ClusterInfo> analyze_clusters(
+    const std::vector<Point3D> &points,
+    const std::vector<int> &labels,
+    bool compute_extents)
+{
     std::vector<ClusterInfo> clusters;
+    int n = std::min(points.size(), labels.size());
+    if (n == 0)
+        return clusters;
+
+    // 1. 스레드별 누적 (슬롯 = 레이블 + 1, 노이즈가 0번)
+    const double ox = points[0].x, oy = points[0].y, oz = points[0].z;
+    std::vector<std::vector<ClusterMoments>> partial(worker_count());
+    parallel_for(0, n, 65536, [&](int begin, int end, int thread_id)
+                 {
+                     std::vector<ClusterMoments> &acc = partial[thread_id];
+                     for (int i = begin; i < end; i++)
+                     {
+                         int slot = labels[i] + 1;
+                         if (slot < 0)
+                             continue;
+                         if (slot >= (int)acc.size())
+                             acc.resize(slot + 1);
 
-    for (auto &pair : cluster_map)
+                         const Point3D &p = points[i];
+                         double x = p.x - ox, y = p.y - oy, z = p.z - oz;
+                         ClusterMoments &m = acc[slot];
+                         m.count++;
+                         m.sx += x;
+                         m.sy += y;
+                         m.sz += z;
+                         m.sxx += x * x;
+                         m.sxy += x * y;
+                         m.sxz += x * z;
+                         m.syy += y * y;
+                         m.syz += y * z;
+                         m.szz += z * z;
+                         m.lo[0] = std::min(m.lo[0], p.x);
+                         m.lo[1] = std::min(m.lo[1], p.y);
+                         m.lo[2] = std::min(m.lo[2], p.z);
+                         m.hi[0] = std::max(m.hi[0], p.x);
+                         m.hi[1] = std::max(m.hi[1], p.y);
+                         m.hi[2] = std::max(m.hi[2], p.z);
+                     }
+                 });
+
+    size_t slots = 0;
+    for (const auto &acc : partial)
     {
-        int id = pair.first;
-        std::vector<int> &indices = pair.second;
+        slots = std::max(slots, acc.size());
+    }
+    std::vector<ClusterMoments> total(slots);
+    for (const auto &acc : partial)
+    {
+        for (size_t s = 0; s < acc.size(); s++)
+        {
+            ClusterMoments &t = total[s];
+            const ClusterMoments &m = acc[s];
+            t.count += m.count;
+            t.sx += m.sx;
+            t.sy += m.sy;
+            t.sz += m.sz;
+            t.sxx += m.sxx;
+            t.sxy += m.sxy;
+            t.sxz += m.sxz;
+            t.syy += m.syy;
+            t.syz += m.syz;
+            t.szz += m.szz;
+            for (int d = 0; d < 3; d++)
+            {
+                t.lo[d] = std::min(t.lo[d], m.lo[d]);
+                t.hi[d] = std::max(t.hi[d], m.hi[d]);
+            }
+        }
+    }
+    partial.clear();
+
+    // 2. 중심, 공분산, PCA 주축
+    std::vector<int> slot_cluster(slots, -1);
+    for (size_t s = 0; s < slots; s++)
+    {
+        const ClusterMoments &m = total[s];
+        if (m.count == 0)
+            continue;
 
         ClusterInfo info;
-        info.id = id;
-        info.size = indices.size();
+        info.id = (int)s - 1;
+        info.size = m.count;
 
-        // 중심 계산
-        Point3D sum(0, 0, 0);
-        for (int idx : indices)
+        double cx = m.sx / m.count, cy = m.sy / m.count, cz = m.sz / m.count;
+        info.center = Point3D(cx + ox, cy + oy, cz + oz);
+        info.radius = -1.0f;
+        info.aabb_min = Point3D(m.lo[0], m.lo[1], m.lo[2]);
+        info.aabb_max = Point3D(m.hi[0], m.hi[1], m.hi[2]);
+
+        double cov[6] = {m.sxx / m.count - cx * cx, m.sxy / m.count - cx * cy, m.sxz / m.count - cx * cz,
+                         m.syy / m.count - cy * cy, m.syz / m.count - cy * cz, m.szz / m.count - cz * cz};
+        for (int k = 0; k < 6; k++)
         {
-            sum.x += points[idx].x;
-            sum.y += points[idx].y;
-            sum.z += points[idx].z;
+            info.covariance[k] = cov[k];
         }
-        info.center.x = sum.x / indices.size();
-        info.center.y = sum.y / indices.size();
-        info.center.z = sum.z / indices.size();
 
-        // 반경 계산
-        float max_dist = 0;
-        for (int idx : indices)
+        double values[3], vectors[2][3];
+        principal_axes(cov, values, vectors);
+        for (int k = 0; k < 3; k++)
         {
-            float dx = points[idx].x - info.center.x;
-            float dy = points[idx].y - info.center.y;
-            float dz = points[idx].z - info.center.z;
-            float dist = std::sqrt(dx * dx + dy * dy + dz * dz);
-            if (dist > max_dist)
-                max_dist = dist;
+            info.variances[k] = std::max(values[k], 0.0);
         }
-        info.radius = max_dist;
+        info.axes[0] = Point3D(vectors[0][0], vectors[0][1], vectors[0][2]);
+        info.axes[1] = Point3D(vectors[1][0], vectors[1][1], vectors[1][2]);
+        // 세 번째 축 = 앞 두 축의 외적 (오른손 좌표계)
+        const Point3D &a0 = info.axes[0], &a1 = info.axes[1];
+        info.axes[2] = Point3D(a0.y * a1.z - a0.z * a1.y, a0.z * a1.x - a0.x * a1.z, a0.x * a1.y - a0.y * a1.x);
 
+        // AABB 꼭짓점을 주축에 투영한 범위 (두 번째 패스가 없을 때의 OBB)
+        float half[3] = {0, 0, 0}, mid[3] = {0, 0, 0};
+        float ext[3] = {(m.hi[0] - m.lo[0]) * 0.5f, (m.hi[1] - m.lo[1]) * 0.5f, (m.hi[2] - m.lo[2]) * 0.5f};
+        float box[3] = {(m.hi[0] + m.lo[0]) * 0.5f - info.center.x, (m.hi[1] + m.lo[1]) * 0.5f - info.center.y,
+                        (m.hi[2] + m.lo[2]) * 0.5f - info.center.z};
+        for (int k = 0; k < 3; k++)
+        {
+            const Point3D &a = info.axes[k];
+            mid[k] = box[0] * a.x + box[1] * a.y + box[2] * a.z;
+            half[k] = ext[0] * std::fabs(a.x) + ext[1] * std::fabs(a.y) + ext[2] * std::fabs(a.z);
+        }
+        info.obb_half_extent = Point3D(half[0], half[1], half[2]);
+        info.obb_center = Point3D(info.center.x + mid[0] * info.axes[0].x + mid[1] * info.axes[1].x + mid[2] * info.axes[2].x,
+                                  info.center.y + mid[0] * info.axes[0].y + mid[1] * info.axes[1].y + mid[2] * info.axes[2].y,
+                                  info.center.z + mid[0] * info.axes[0].z + mid[1] * info.axes[1].z + mid[2] * info.axes[2].z);
+
+        slot_cluster[s] = clusters.size();
         clusters.push_back(info);
     }
 
+    // 3. 요청 시 두 번째 패스: 중심 기준 주축 투영 범위 + 최대 거리 제곱 (sqrt는 클러스터당 한 번)
+    if (compute_extents)
+    {
+        // 클러스터별 중심/주축을 SIMD 레인 배치로 준비 (col[d] = 각 주축의 d 성분)
+        struct alignas(16) ClusterFrame
+        {
+            float center[4];
+            float col[3][4];
+        };
+        std::vector<ClusterFrame> frames(slots);
+        for (size_t s = 0; s < slots; s++)
+        {
+            if (slot_cluster[s] == -1)
+                continue;
+
+            const ClusterInfo &info = clusters[slot_cluster[s]];
+            ClusterFrame &f = frames[s];
+            f.center[0] = info.center.x;
+            f.center[1] = info.center.y;
+            f.center[2] = info.center.z;
+            f.center[3] = 0.0f;
+            for (int k = 0; k < 3; k++)
+            {
+                f.col[0][k] = info.axes[k].x;
+                f.col[1][k] = info.axes[k].y;
+                f.col[2][k] = info.axes[k].z;
+            }
+            f.col[0][3] = f.col[1][3] = f.col[2][3] = 0.0f;
+        }
+
+        std::vector<std::vector<ClusterExtent>> extents(worker_count());
+        parallel_for(0, n, 65536, [&](int begin, int end, int thread_id)
+                     {
+                         std::vector<ClusterExtent> &acc = extents[thread_id];
+                         if (acc.empty())
+                         {
+                             ClusterExtent init;
+                             for (int d = 0; d < 4; d++)
+                             {
+                                 init.lo[d] = std::numeric_limits<float>::max();
+                                 init.hi[d] = std::numeric_limits<float>::lowest();
+                             }
+                             init.max_d2 = 0.0f;
+                             acc.assign(slots, init);
+                         }
+
+                         for (int i = begin; i < end; i++)
+                         {
+                             int slot = labels[i] + 1;
+                             if (slot < 0)
+                                 continue;
+
+                             const Point3D &p = points[i];
+                             const ClusterFrame &f = frames[slot];
+                             ClusterExtent &e = acc[slot];
+#ifdef CLUSTERING_USE_SSE2
+                             __m128 c = _mm_load_ps(f.center);
+                             __m128 d = _mm_sub_ps(_mm_set_ps(0.0f, p.z, p.y, p.x), c);
+                             __m128 sq = _mm_mul_ps(d, d);
+                             __m128 d2 = _mm_add_ss(_mm_add_ss(sq, _mm_shuffle_ps(sq, sq, 1)), _mm_movehl_ps(sq, sq));
+                             // 투영 = dx * col0 + dy * col1 + dz * col2 (레인 k = k번째 주축)
+                             __m128 proj = _mm_add_ps(_mm_add_ps(
+                                                          _mm_mul_ps(_mm_shuffle_ps(d, d, 0x00), _mm_load_ps(f.col[0])),
+                                                          _mm_mul_ps(_mm_shuffle_ps(d, d, 0x55), _mm_load_ps(f.col[1]))),
+                                                      _mm_mul_ps(_mm_shuffle_ps(d, d, 0xAA), _mm_load_ps(f.col[2])));
+                             _mm_store_ps(e.lo, _mm_min_ps(_mm_load_ps(e.lo), proj));
+                             _mm_store_ps(e.hi, _mm_max_ps(_mm_load_ps(e.hi), proj));
+                             _mm_store_ss(&e.max_d2, _mm_max_ss(_mm_load_ss(&e.max_d2), d2));
+#else
+                             float dx = p.x - f.center[0], dy = p.y - f.center[1], dz = p.z - f.center[2];
+                             e.max_d2 = std::max(e.max_d2, dx * dx + dy * dy + dz * dz);
+                             for (int k = 0; k < 3; k++)
+                             {
+                                 float proj = dx * f.col[0][k] + dy * f.col[1][k] + dz * f.col[2][k];
+                                 e.lo[k] = std::min(e.lo[k], proj);
+                                 e.hi[k] = std::max(e.hi[k], proj);
+                             }
+#endif
+                         }
+                     });
+
+        for (size_t s = 0; s < slots; s++)
+        {
+            if (slot_cluster[s] == -1)
+                continue;
+
+            float lo[3] = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                           std::numeric_limits<float>::max()};
+            float hi[3] = {std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(),
+                           std::numeric_limits<float>::lowest()};
+            float max_d2 = 0.0f;
+            for (const auto &acc : extents)
+            {
+                if (acc.empty())
+                    continue;
+                for (int k = 0; k < 3; k++)
+                {
+                    lo[k] = std::min(lo[k], acc[s].lo[k]);
+                    hi[k] = std::max(hi[k], acc[s].hi[k]);
+                }
+                max_d2 = std::max(max_d2, acc[s].max_d2);
+            }
+
+            ClusterInfo &info = clusters[slot_cluster[s]];
+            info.radius = std::sqrt(max_d2);
+
+            float mid[3];
+            for (int k = 0; k < 3; k++)
+            {
+                mid[k] = (lo[k] + hi[k]) * 0.5f;
+            }
+            info.obb_half_extent = Point3D((hi[0] - lo[0]) * 0.5f, (hi[1] - lo[1]) * 0.5f, (hi[2] - lo[2]) * 0.5f);
+            info.obb_center = Point3D(info.center.x + mid[0] * info.axes[0].x + mid[1] * info.axes[1].x + mid[2] * info.axes[2].x,
+                                      info.center.y + mid[0] * info.axes[0].y + mid[1] * info.axes[1].y + mid[2] * info.axes[2].y,
+                                      info.center.z + mid[0] * info.axes[0].z + mid[1] * info.axes[1].z + mid[2] * info.axes[2].z);
+        }
+    }
+
     // 크기 순 정렬
     std::sort(clusters.begin(), clusters.end(),
               [](const ClusterInfo &a, const ClusterInfo &b)
@@ -67,6 +367,110 @@ std::vector<ClusterInfo> analyze_clusters(
     return clusters;
 }
 
+std::vector<float> core_ratio_curve(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    const std::vector<float> &radii,
+    int min_points)
+{
+    int n = points.size();
+    int radius_count = radii.size();
+    std::vector<float> ratios(radius_count, 0.0f);
+
+    if (n == 0 || radius_count == 0)
+        return ratios;
+
+    // 스레드별 코어 점 개수
+    std::vector<std::vector<int>> core_counts(worker_count(), std::vector<int>(radius_count, 0));
+
+    parallel_for(0, n, 4096, [&](int begin, int end, int thread_id)
+                 {
+                     std::vector<int> counts(radius_count);
+                     std::vector<int> &local = core_counts[thread_id];
+                     for (int i = begin; i < end; i++)
+                     {
+                         tree.count_radius_multi(points[i], radii, counts.data());
+                         for (int k = 0; k < radius_count; k++)
+                         {
+                             if (counts[k] >= min_points)
+                                 local[k]++;
+                         }
+                     }
+                 });
+
+    for (const auto &local : core_counts)
+    {
+        for (int k = 0; k < radius_count; k++)
+        {
+            ratios[k] += local[k];
+        }
+    }
+    for (float &r : ratios)
+    {
+        r /= n;
+    }
+
+    return ratios;
+}
+
+KDistanceCurve compute_k_distance_curve(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    int k,
+    float sample_ratio)
+{
+    KDistanceCurve curve;
+    curve.k = k;
+
+    int n = points.size();
+    if (n == 0 || k <= 0)
+        return curve;
+
+    // 등간격 표본 (OBJ 정점 순서는 대체로 공간적으로 이어져 있어 연속 쿼리가 같은 서브트리를 탐색)
+    int step = std::max(1, (int)std::lround(1.0f / std::max(sample_ratio, 1e-6f)));
+    int sample_count = (n + step - 1) / step;
+
+    std::vector<float> distances(sample_count);
+    parallel_for(0, sample_count, 1024, [&](int begin, int end, int)
+                 {
+                     for (int s = begin; s < end; s++)
+                     {
+                         distances[s] = tree.kth_distance(points[(size_t)s * step], k);
+                     }
+                 });
+
+    // 점이 k개보다 적으면 -1
+    distances.erase(std::remove(distances.begin(), distances.end(), -1.0f), distances.end());
+    if (distances.empty())
+        return curve;
+
+    std::sort(distances.begin(), distances.end());
+
+    // 정규화 후 직선 y = x 아래로 가장 멀리 내려간 점
+    int last = (int)distances.size() - 1 - (int)(distances.size() / 100);
+    float low = distances.front();
+    float range = distances[last] - low;
+
+    curve.knee_index = last;
+    if (last > 0 && range > 0.0f)
+    {
+        float best = -1.0f;
+        for (int i = 0; i <= last; i++)
+        {
+            float gap = (float)i / last - (distances[i] - low) / range;
+            if (gap > best)
+            {
+                best = gap;
+                curve.knee_index = i;
+            }
+        }
+    }
+    curve.suggested_epsilon = distances[curve.knee_index];
+    curve.distances.swap(distances);
+
+    return curve;
+}
+
 std::vector<int> dbscan_clustering_kdtree(
     const std::vector<Point3D> &points,
     KDTree &tree,
@@ -79,6 +483,14 @@ std::vector<int> dbscan_clustering_kdtree(
 
     std::cout << "DBSCAN 클러스터링 시작..." << std::endl;
 
+    // 패킷 탐색용 버퍼
+    Point3D targets[KDTREE_PACKET_SIZE];
+    std::vector<int> batch_neighbors[KDTREE_PACKET_SIZE];
+
+    // 확장 대기열: 프런티어를 레벨마다 교체, enqueued 비트셋으로 중복 삽입 방지
+    std::vector<bool> enqueued(n, false);
+    std::vector<int> frontier, next_frontier;
+
     for (int i = 0; i < n; i++)
     {
         if (labels[i] != -2)
@@ -95,47 +507,63 @@ std::vector<int> dbscan_clustering_kdtree(
 
         // 새 클러스터 시작
         labels[i] = cluster_id;
+        enqueued[i] = true;
 
-        // 클러스터 확장 (BFS)
-        std::queue<int> to_expand;
+        // 클러스터 확장 (레벨 단위 BFS, 점마다 프런티어에 한 번만 들어감)
+        frontier.clear();
         for (int neighbor : neighbors)
         {
-            if (neighbor != i)
+            if (labels[neighbor] == -1)
             {
-                to_expand.push(neighbor);
+                labels[neighbor] = cluster_id; // 노이즈였던 점은 경계점으로 포함
+            }
+            else if (labels[neighbor] == -2 && !enqueued[neighbor])
+            {
+                enqueued[neighbor] = true;
+                frontier.push_back(neighbor);
             }
         }
 
-        while (!to_expand.empty())
+        while (!frontier.empty())
         {
-            int current = to_expand.front();
-            to_expand.pop();
+            next_frontier.clear();
 
-            // 노이즈였던 점을 클러스터에 포함
-            if (labels[current] == -1)
+            // 프런티어 점들은 서로 가까우므로 KDTREE_PACKET_SIZE개씩 묶어서 한 번에 탐색
+            for (size_t start = 0; start < frontier.size(); start += KDTREE_PACKET_SIZE)
             {
-                labels[current] = cluster_id;
-            }
-
-            if (labels[current] != -2)
-                continue; // 이미 처리됨
-
-            labels[current] = cluster_id;
+                int count = std::min(frontier.size() - start, (size_t)KDTREE_PACKET_SIZE);
+                for (int q = 0; q < count; q++)
+                {
+                    int current = frontier[start + q];
+                    labels[current] = cluster_id;
+                    targets[q] = points[current];
+                    batch_neighbors[q].clear();
+                }
 
-            // current의 이웃도 찾기
-            std::vector<int> current_neighbors = tree.find_radius(points[current], radius);
+                tree.find_radius_packet(targets, count, radius, batch_neighbors);
 
-            // 밀집 지역이면 이웃들도 확장
-            if ((int)current_neighbors.size() >= min_points)
-            {
-                for (int neighbor : current_neighbors)
+                for (int q = 0; q < count; q++)
                 {
-                    if (labels[neighbor] == -2 || labels[neighbor] == -1)
+                    // 밀집 지역이면 이웃들도 확장
+                    if ((int)batch_neighbors[q].size() < min_points)
+                        continue;
+
+                    for (int neighbor : batch_neighbors[q])
                     {
-                        to_expand.push(neighbor);
+                        if (labels[neighbor] == -1)
+                        {
+                            labels[neighbor] = cluster_id;
+                        }
+                        else if (labels[neighbor] == -2 && !enqueued[neighbor])
+                        {
+                            enqueued[neighbor] = true;
+                            next_frontier.push_back(neighbor);
+                        }
                     }
                 }
             }
+
+            frontier.swap(next_frontier);
         }
 
         cluster_id++;
@@ -151,4 +579,1236 @@ std::vector<int> dbscan_clustering_kdtree(
     std::cout << "DBSCAN 완료! 총 " << cluster_id << "개 클러스터" << std::endl;
 
     return labels;
-}
\ No newline at end of file
+}
+
+// ==================== 병렬 DBSCAN ====================
+
+// lock-free union-find 루트 찾기 (경로 절반 압축)
+static int find_root(std::atomic<int> *parent, int x)
+{
+    for (;;)
+    {
+        int p = parent[x].load(std::memory_order_relaxed);
+        if (p == x)
+            return x;
+
+        int gp = parent[p].load(std::memory_order_relaxed);
+        if (p != gp)
+        {
+            parent[x].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+        }
+        x = gp;
+    }
+}
+
+// 항상 큰 루트를 작은 루트 아래로 연결 -> 최종 루트는 집합의 최소 인덱스
+static void unite(std::atomic<int> *parent, int a, int b)
+{
+    for (;;)
+    {
+        a = find_root(parent, a);
+        b = find_root(parent, b);
+        if (a == b)
+            return;
+        if (a > b)
+            std::swap(a, b);
+
+        int expected = b;
+        if (parent[b].compare_exchange_strong(expected, a, std::memory_order_relaxed))
+            return;
+    }
+}
+
+std::vector<int> dbscan_clustering_parallel(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    float radius,
+    int min_points)
+{
+    int n = points.size();
+    std::vector<int> labels(n, -1); // -1: 노이즈, 0~: 클러스터
+
+    std::cout << "병렬 DBSCAN 클러스터링 시작... (스레드 " << worker_count() << "개)" << std::endl;
+
+    // 블록이 공간적으로 모이도록 트리 순서로 처리
+    std::vector<int> order = tree.spatial_order();
+
+    // 1. 코어 점 판정 (패킷 탐색)
+    std::vector<char> is_core(n, 0);
+    parallel_for(0, n, 4096, [&](int begin, int end, int)
+                 {
+                     Point3D targets[KDTREE_PACKET_SIZE];
+                     int counts[KDTREE_PACKET_SIZE];
+                     for (int start = begin; start < end; start += KDTREE_PACKET_SIZE)
+                     {
+                         int count = std::min(end - start, KDTREE_PACKET_SIZE);
+                         for (int q = 0; q < count; q++)
+                         {
+                             targets[q] = points[order[start + q]];
+                         }
+
+                         tree.count_radius_packet(targets, count, radius, counts);
+
+                         for (int q = 0; q < count; q++)
+                         {
+                             is_core[order[start + q]] = counts[q] >= min_points;
+                         }
+                     }
+                 });
+
+    // 2. 이웃한 코어 점끼리 연결
+    std::unique_ptr<std::atomic<int>[]> parent(new std::atomic<int>[n]);
+    for (int i = 0; i < n; i++)
+    {
+        parent[i].store(i, std::memory_order_relaxed);
+    }
+
+    parallel_for(0, n, 4096, [&](int begin, int end, int)
+                 {
+                     // 블록 안의 코어 점을 패킷으로 묶어서 탐색
+                     int batch[KDTREE_PACKET_SIZE];
+                     Point3D targets[KDTREE_PACKET_SIZE];
+                     std::vector<int> neighbors[KDTREE_PACKET_SIZE];
+
+                     int k = begin;
+                     while (k < end)
+                     {
+                         int count = 0;
+                         for (; k < end && count < KDTREE_PACKET_SIZE; k++)
+                         {
+                             if (is_core[order[k]])
+                             {
+                                 batch[count] = order[k];
+                                 targets[count] = points[order[k]];
+                                 neighbors[count].clear();
+                                 count++;
+                             }
+                         }
+
+                         tree.find_radius_packet(targets, count, radius, neighbors);
+
+                         for (int q = 0; q < count; q++)
+                         {
+                             int i = batch[q];
+                             for (int neighbor : neighbors[q])
+                             {
+                                 // 쌍마다 한 번만 연결
+                                 if (neighbor > i && is_core[neighbor])
+                                 {
+                                     unite(parent.get(), i, neighbor);
+                                 }
+                             }
+                         }
+                     }
+                 });
+
+    // 3. 클러스터 번호: 루트(= 클러스터의 최소 코어 인덱스) 오름차순
+    //    직렬 버전도 인덱스 순으로 시드를 잡으므로 번호가 같음
+    std::vector<int> root_id(n, -1);
+    int cluster_id = 0;
+    for (int i = 0; i < n; i++)
+    {
+        if (is_core[i] && find_root(parent.get(), i) == i)
+        {
+            root_id[i] = cluster_id++;
+        }
+    }
+
+    parallel_for(0, n, 65536, [&](int begin, int end, int)
+                 {
+                     for (int i = begin; i < end; i++)
+                     {
+                         if (is_core[i])
+                             labels[i] = root_id[find_root(parent.get(), i)];
+                     }
+                 });
+
+    // 4. 경계점: 이웃 코어 점 중 가장 작은 클러스터 번호
+    //    (직렬 버전은 번호 순으로 클러스터를 확장하므로 먼저 도달한 클러스터 = 가장 작은 번호)
+    parallel_for(0, n, 4096, [&](int begin, int end, int)
+                 {
+                     int batch[KDTREE_PACKET_SIZE];
+                     Point3D targets[KDTREE_PACKET_SIZE];
+                     std::vector<int> neighbors[KDTREE_PACKET_SIZE];
+
+                     int k = begin;
+                     while (k < end)
+                     {
+                         int count = 0;
+                         for (; k < end && count < KDTREE_PACKET_SIZE; k++)
+                         {
+                             if (!is_core[order[k]])
+                             {
+                                 batch[count] = order[k];
+                                 targets[count] = points[order[k]];
+                                 neighbors[count].clear();
+                                 count++;
+                             }
+                         }
+
+                         tree.find_radius_packet(targets, count, radius, neighbors);
+
+                         for (int q = 0; q < count; q++)
+                         {
+                             int best = -1;
+                             for (int neighbor : neighbors[q])
+                             {
+                                 if (!is_core[neighbor])
+                                     continue;
+                                 int id = labels[neighbor];
+                                 if (best == -1 || id < best)
+                                     best = id;
+                             }
+                             labels[batch[q]] = best;
+                         }
+                     }
+                 });
+
+    std::cout << "병렬 DBSCAN 완료! 총 " << cluster_id << "개 클러스터" << std::endl;
+
+    return labels;
+}
+
+// ==================== 격자 DBSCAN ====================
+
+// 격자 셀 (정렬된 점 배열의 [begin, end) 구간)
+struct GridCell
+{
+    int ix, iy, iz;
+    int begin, end;
+};
+
+// 셀 좌표 -> 64비트 키 (축마다 21비트)
+static uint64_t grid_key(int ix, int iy, int iz)
+{
+    return (uint64_t)ix << 42 | (uint64_t)iy << 21 | (uint64_t)iz;
+}
+
+// distance()와 같은 연산 순서로 반경 비교
+static bool within_radius(const Point3D &a, const Point3D &b, float radius)
+{
+    float dx = a.x - b.x;
+    float dy = a.y - b.y;
+    float dz = a.z - b.z;
+    return std::sqrt(dx * dx + dy * dy + dz * dz) <= radius;
+}
+
+std::vector<int> dbscan_clustering_grid(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    float radius,
+    int min_points,
+    std::vector<char> *core_flags)
+{
+    int n = points.size();
+    std::vector<int> labels(n, -1);
+
+    if (n == 0)
+        return labels;
+
+    std::cout << "격자 DBSCAN 클러스터링 시작..." << std::endl;
+
+    // 1. 격자 크기: 대각선이 radius보다 약간 작도록 (float 반올림 여유)
+    double cell = radius / std::sqrt(3.0) * (1.0 - 1e-5);
+
+    Point3D lo = points[0], hi = points[0];
+    for (const auto &p : points)
+    {
+        lo.x = std::min(lo.x, p.x);
+        lo.y = std::min(lo.y, p.y);
+        lo.z = std::min(lo.z, p.z);
+        hi.x = std::max(hi.x, p.x);
+        hi.y = std::max(hi.y, p.y);
+        hi.z = std::max(hi.z, p.z);
+    }
+
+    const double max_cells = (1 << 21) - 1;
+    double extent = std::max((double)hi.x - lo.x, std::max((double)hi.y - lo.y, (double)hi.z - lo.z));
+    if (!(cell > 0) || extent / cell >= max_cells)
+    {
+        std::cout << "  격자가 너무 큼 -> KD-Tree 병렬 DBSCAN 사용" << std::endl;
+        if (core_flags)
+        {
+            core_flags->assign(n, 0);
+            parallel_for(0, n, 4096, [&](int begin, int end, int)
+                         {
+                             int counts[KDTREE_PACKET_SIZE];
+                             for (int start = begin; start < end; start += KDTREE_PACKET_SIZE)
+                             {
+                                 int count = std::min(end - start, KDTREE_PACKET_SIZE);
+                                 tree.count_radius_packet(&points[start], count, radius, counts);
+                                 for (int q = 0; q < count; q++)
+                                     (*core_flags)[start + q] = counts[q] >= min_points;
+                             }
+                         });
+        }
+        return dbscan_clustering_parallel(points, tree, radius, min_points);
+    }
+
+    // 2. 셀 키로 점 정렬
+    std::vector<std::pair<uint64_t, int>> keyed(n);
+    parallel_for(0, n, 65536, [&](int begin, int end, int)
+                 {
+                     for (int i = begin; i < end; i++)
+                     {
+                         int ix = (int)((points[i].x - (double)lo.x) / cell);
+                         int iy = (int)((points[i].y - (double)lo.y) / cell);
+                         int iz = (int)((points[i].z - (double)lo.z) / cell);
+                         keyed[i] = {grid_key(ix, iy, iz), i};
+                     }
+                 });
+    std::sort(keyed.begin(), keyed.end());
+
+    std::vector<int> sorted(n);
+    std::vector<GridCell> cells;
+    std::unordered_map<uint64_t, int> cell_index;
+    for (int k = 0; k < n; k++)
+    {
+        sorted[k] = keyed[k].second;
+        if (k == 0 || keyed[k].first != keyed[k - 1].first)
+        {
+            uint64_t key = keyed[k].first;
+            GridCell c;
+            c.ix = (int)(key >> 42);
+            c.iy = (int)((key >> 21) & 0x1fffff);
+            c.iz = (int)(key & 0x1fffff);
+            c.begin = k;
+            c.end = k;
+            cell_index[key] = cells.size();
+            cells.push_back(c);
+        }
+        cells.back().end = k + 1;
+    }
+    keyed.clear();
+    keyed.shrink_to_fit();
+
+    int cell_count = cells.size();
+
+    // 3. 이웃 셀 목록 (셀 간 최소 거리가 radius 이하인 범위 = 좌표 차이 ±2)
+    std::vector<std::vector<int>> neighbor_cells(cell_count);
+    parallel_for(0, cell_count, 1024, [&](int begin, int end, int)
+                 {
+                     for (int c = begin; c < end; c++)
+                     {
+                         const GridCell &gc = cells[c];
+                         for (int dx = -2; dx <= 2; dx++)
+                             for (int dy = -2; dy <= 2; dy++)
+                                 for (int dz = -2; dz <= 2; dz++)
+                                 {
+                                     int x = gc.ix + dx, y = gc.iy + dy, z = gc.iz + dz;
+                                     if (x < 0 || y < 0 || z < 0)
+                                         continue;
+                                     auto it = cell_index.find(grid_key(x, y, z));
+                                     if (it != cell_index.end())
+                                         neighbor_cells[c].push_back(it->second);
+                                 }
+                     }
+                 });
+
+    // 4. 코어 점 판정: 밀집 셀은 전부 코어, 나머지만 이웃 셀에서 개수 세기 (min_points 도달 시 중단)
+    std::vector<char> is_core(n, 0);
+    std::vector<char> cell_has_core(cell_count, 0);
+    int dense_cells = 0;
+    for (const auto &gc : cells)
+    {
+        if (gc.end - gc.begin >= min_points)
+            dense_cells++;
+    }
+
+    parallel_for(0, cell_count, 256, [&](int begin, int end, int)
+                 {
+                     for (int c = begin; c < end; c++)
+                     {
+                         const GridCell &gc = cells[c];
+                         if (gc.end - gc.begin >= min_points)
+                         {
+                             for (int k = gc.begin; k < gc.end; k++)
+                                 is_core[sorted[k]] = 1;
+                             cell_has_core[c] = 1;
+                             continue;
+                         }
+
+                         for (int k = gc.begin; k < gc.end; k++)
+                         {
+                             const Point3D &p = points[sorted[k]];
+                             int count = 0;
+                             for (int d : neighbor_cells[c])
+                             {
+                                 for (int m = cells[d].begin; m < cells[d].end && count < min_points; m++)
+                                 {
+                                     if (within_radius(points[sorted[m]], p, radius))
+                                         count++;
+                                 }
+                                 if (count >= min_points)
+                                     break;
+                             }
+                             if (count >= min_points)
+                             {
+                                 is_core[sorted[k]] = 1;
+                                 cell_has_core[c] = 1;
+                             }
+                         }
+                     }
+                 });
+
+    // 5. 코어 셀 연결 (같은 셀의 코어 점은 항상 연결, 이웃 셀은 코어 점 쌍 하나만 찾으면 됨)
+    std::unique_ptr<std::atomic<int>[]> parent(new std::atomic<int>[cell_count]);
+    for (int c = 0; c < cell_count; c++)
+    {
+        parent[c].store(c, std::memory_order_relaxed);
+    }
+
+    parallel_for(0, cell_count, 256, [&](int begin, int end, int)
+                 {
+                     for (int c = begin; c < end; c++)
+                     {
+                         if (!cell_has_core[c])
+                             continue;
+
+                         const GridCell &a = cells[c];
+                         for (int d : neighbor_cells[c])
+                         {
+                             if (d <= c || !cell_has_core[d])
+                                 continue;
+                             if (find_root(parent.get(), c) == find_root(parent.get(), d))
+                                 continue;
+
+                             const GridCell &b = cells[d];
+                             bool linked = false;
+                             for (int k = a.begin; k < a.end && !linked; k++)
+                             {
+                                 if (!is_core[sorted[k]])
+                                     continue;
+                                 const Point3D &p = points[sorted[k]];
+                                 for (int m = b.begin; m < b.end; m++)
+                                 {
+                                     if (is_core[sorted[m]] && within_radius(points[sorted[m]], p, radius))
+                                     {
+                                         linked = true;
+                                         break;
+                                     }
+                                 }
+                             }
+                             if (linked)
+                                 unite(parent.get(), c, d);
+                         }
+                     }
+                 });
+
+    // 6. 클러스터 번호: 클러스터의 최소 코어 인덱스 순 (직렬 버전의 시드 순서)
+    std::vector<int> cell_min_core(cell_count, n);
+    for (int c = 0; c < cell_count; c++)
+    {
+        for (int k = cells[c].begin; k < cells[c].end; k++)
+        {
+            if (is_core[sorted[k]])
+                cell_min_core[c] = std::min(cell_min_core[c], sorted[k]);
+        }
+    }
+
+    std::vector<int> root_min(cell_count, n);
+    for (int c = 0; c < cell_count; c++)
+    {
+        if (cell_has_core[c])
+        {
+            int r = find_root(parent.get(), c);
+            root_min[r] = std::min(root_min[r], cell_min_core[c]);
+        }
+    }
+
+    std::vector<std::pair<int, int>> roots; // (최소 코어 인덱스, 루트 셀)
+    for (int c = 0; c < cell_count; c++)
+    {
+        if (cell_has_core[c] && find_root(parent.get(), c) == c)
+            roots.push_back({root_min[c], c});
+    }
+    std::sort(roots.begin(), roots.end());
+
+    std::vector<int> root_id(cell_count, -1);
+    for (size_t r = 0; r < roots.size(); r++)
+    {
+        root_id[roots[r].second] = r;
+    }
+
+    std::vector<int> cell_cluster(cell_count, -1);
+    for (int c = 0; c < cell_count; c++)
+    {
+        if (cell_has_core[c])
+            cell_cluster[c] = root_id[find_root(parent.get(), c)];
+    }
+
+    // 7. 레이블: 코어는 셀의 클러스터, 경계점은 반경 안 코어가 있는 셀 중 가장 작은 번호
+    parallel_for(0, cell_count, 256, [&](int begin, int end, int)
+                 {
+                     for (int c = begin; c < end; c++)
+                     {
+                         for (int k = cells[c].begin; k < cells[c].end; k++)
+                         {
+                             int i = sorted[k];
+                             if (is_core[i])
+                             {
+                                 labels[i] = cell_cluster[c];
+                                 continue;
+                             }
+
+                             int best = -1;
+                             for (int d : neighbor_cells[c])
+                             {
+                                 int id = cell_cluster[d];
+                                 if (id == -1 || (best != -1 && id >= best))
+                                     continue;
+                                 for (int m = cells[d].begin; m < cells[d].end; m++)
+                                 {
+                                     if (is_core[sorted[m]] && within_radius(points[sorted[m]], points[i], radius))
+                                     {
+                                         best = id;
+                                         break;
+                                     }
+                                 }
+                             }
+                             labels[i] = best;
+                         }
+                     }
+                 });
+
+    std::cout << "격자 DBSCAN 완료! 셀 " << cell_count << "개 (밀집 셀 " << dense_cells
+              << "개), 총 " << roots.size() << "개 클러스터" << std::endl;
+
+    if (core_flags)
+        core_flags->swap(is_core);
+
+    return labels;
+}
+
+// ==================== 밀도 적응 DBSCAN ====================
+
+// 점마다 반경이 다른 탐색: items(트리 순서)를 반경이 비슷한 것끼리 패킷으로 묶어 탐색
+// 반경을 2^(1/4)배 구간으로 나누고 구간 안에서는 트리 순서 유지 -> 패킷 반경(= 최대 반경)이 크게 부풀지 않음
+// visit(i, neighbors): neighbors는 거리 <= radii[i]인 점
+template <typename Visit>
+static void search_packets_by_radius(const std::vector<Point3D> &points, KDTree &tree,
+                                     const std::vector<float> &radii, const std::vector<int> &items,
+                                     Visit visit)
+{
+    std::vector<std::pair<int, int>> keyed(items.size()); // (반경 구간, items 위치)
+    for (size_t k = 0; k < items.size(); k++)
+    {
+        float r = radii[items[k]];
+        keyed[k] = {r > 0.0f ? (int)std::floor(std::log2(r) * 4.0f) : std::numeric_limits<int>::min(), (int)k};
+    }
+    std::sort(keyed.begin(), keyed.end());
+
+    int batch[KDTREE_PACKET_SIZE];
+    Point3D targets[KDTREE_PACKET_SIZE];
+    std::vector<int> neighbors[KDTREE_PACKET_SIZE];
+
+    for (size_t start = 0; start < keyed.size(); start += KDTREE_PACKET_SIZE)
+    {
+        int count = std::min(keyed.size() - start, (size_t)KDTREE_PACKET_SIZE);
+        float max_radius = 0.0f;
+        for (int q = 0; q < count; q++)
+        {
+            batch[q] = items[keyed[start + q].second];
+            targets[q] = points[batch[q]];
+            neighbors[q].clear();
+            max_radius = std::max(max_radius, radii[batch[q]]);
+        }
+
+        if (max_radius < 0.0f)
+            continue;
+
+        tree.find_radius_packet(targets, count, max_radius, neighbors);
+
+        for (int q = 0; q < count; q++)
+        {
+            int i = batch[q];
+            std::vector<int> &list = neighbors[q];
+            if (radii[i] < max_radius)
+            {
+                list.erase(std::remove_if(list.begin(), list.end(),
+                                          [&](int j)
+                                          { return !within_radius(points[i], points[j], radii[i]); }),
+                           list.end());
+            }
+            visit(i, list);
+        }
+    }
+}
+
+std::vector<float> compute_local_scales(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    int k)
+{
+    int n = points.size();
+    std::vector<float> k_distances(n, -1.0f);
+    std::vector<float> scales(n, -1.0f);
+
+    std::vector<int> order = tree.spatial_order();
+
+    // 1. 점별 k번째 이웃 거리
+    parallel_for(0, n, 4096, [&](int begin, int end, int)
+                 {
+                     for (int j = begin; j < end; j++)
+                     {
+                         int i = order[j];
+                         k_distances[i] = tree.kth_distance(points[i], k);
+                     }
+                 });
+
+    // 2. k-최근접 이웃(= k번째 이웃 거리 안의 점)의 k-거리 중앙값
+    //    밀집 면 옆의 노이즈 점은 자기 k-거리가 커도 이웃인 면 점들의 작은 값을 받음
+    parallel_for(0, n, 4096, [&](int begin, int end, int)
+                 {
+                     std::vector<int> items(order.begin() + begin, order.begin() + end);
+                     std::vector<float> values;
+                     search_packets_by_radius(points, tree, k_distances, items,
+                                              [&](int i, const std::vector<int> &neighbors)
+                                              {
+                                                  if (neighbors.empty())
+                                                      return;
+
+                                                  values.clear();
+                                                  for (int neighbor : neighbors)
+                                                  {
+                                                      values.push_back(k_distances[neighbor]);
+                                                  }
+
+                                                  auto middle = values.begin() + values.size() / 2;
+                                                  std::nth_element(values.begin(), middle, values.end());
+                                                  scales[i] = *middle;
+                                              });
+                 });
+
+    return scales;
+}
+
+std::vector<int> dbscan_clustering_adaptive(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    const std::vector<float> &local_scales,
+    float scale,
+    float max_radius,
+    int min_points)
+{
+    int n = points.size();
+    std::vector<int> labels(n, -1);
+
+    std::cout << "밀도 적응 DBSCAN 클러스터링 시작... (반경 = min(" << scale << " x 국소 거리, " << max_radius
+              << "))" << std::endl;
+
+    std::vector<float> radii(n);
+    for (int i = 0; i < n; i++)
+    {
+        radii[i] = std::min(scale * local_scales[i], max_radius);
+    }
+
+    // 이웃 관계: 거리 <= min(r_p, r_q) (r_p 탐색 결과에서 상대 반경 밖인 점 제외)
+    auto mutual = [&](int i, int j)
+    { return radii[j] >= radii[i] || within_radius(points[i], points[j], radii[j]); };
+
+    std::vector<int> order = tree.spatial_order();
+
+    // 1. 코어 점 판정 (탐색은 이 한 번뿐, 뒤 단계에 필요한 이웃만 블록별로 저장)
+    //    코어: 연결용으로 자기보다 번호가 큰 이웃 / 코어가 아님: 경계점 배정용으로 모든 이웃 (MinPts개 미만)
+    //    상대가 코어인지는 모든 블록이 끝나야 알 수 있으므로 거르지 않고 저장
+    const int block_size = 4096;
+    std::vector<char> is_core(n, 0);
+    std::vector<std::vector<int>> block_neighbors((n + block_size - 1) / block_size);
+    std::vector<int> row_begin(n), row_size(n); // 점별 저장 위치 (자기 블록 배열 안)
+    parallel_for(0, n, block_size, [&](int begin, int end, int)
+                 {
+                     std::vector<int> items(order.begin() + begin, order.begin() + end);
+                     std::vector<int> &flat = block_neighbors[begin / block_size];
+                     search_packets_by_radius(points, tree, radii, items,
+                                              [&](int i, const std::vector<int> &neighbors)
+                                              {
+                                                  row_begin[i] = flat.size();
+                                                  int count = 0;
+                                                  for (int neighbor : neighbors)
+                                                  {
+                                                      if (mutual(i, neighbor))
+                                                      {
+                                                          count++;
+                                                          flat.push_back(neighbor);
+                                                      }
+                                                  }
+                                                  is_core[i] = count >= min_points;
+
+                                                  if (is_core[i])
+                                                  {
+                                                      auto last = std::remove_if(flat.begin() + row_begin[i], flat.end(),
+                                                                                 [i](int j)
+                                                                                 { return j <= i; });
+                                                      flat.erase(last, flat.end());
+                                                  }
+                                                  row_size[i] = flat.size() - row_begin[i];
+                                              });
+                 });
+    if (task_cancelled())
+        return labels;
+
+    // 2. 이웃한 코어 점끼리 연결 (이웃 관계가 대칭이라 쌍마다 한 번만)
+    std::unique_ptr<std::atomic<int>[]> parent(new std::atomic<int>[n]);
+    for (int i = 0; i < n; i++)
+    {
+        parent[i].store(i, std::memory_order_relaxed);
+    }
+
+    parallel_for(0, n, block_size, [&](int begin, int end, int)
+                 {
+                     const int *flat = block_neighbors[begin / block_size].data();
+                     for (int k = begin; k < end; k++)
+                     {
+                         int i = order[k];
+                         if (!is_core[i])
+                             continue;
+                         const int *row = flat + row_begin[i];
+                         for (int r = 0; r < row_size[i]; r++)
+                         {
+                             if (is_core[row[r]])
+                                 unite(parent.get(), i, row[r]);
+                         }
+                     }
+                 });
+
+    // 3. 클러스터 번호: 최소 코어 인덱스 순
+    std::vector<int> root_id(n, -1);
+    int cluster_id = 0;
+    for (int i = 0; i < n; i++)
+    {
+        if (is_core[i] && find_root(parent.get(), i) == i)
+        {
+            root_id[i] = cluster_id++;
+        }
+    }
+
+    parallel_for(0, n, 65536, [&](int begin, int end, int)
+                 {
+                     for (int i = begin; i < end; i++)
+                     {
+                         if (is_core[i])
+                             labels[i] = root_id[find_root(parent.get(), i)];
+                     }
+                 });
+
+    // 4. 경계점: 이웃 코어 점 중 가장 작은 클러스터 번호
+    parallel_for(0, n, block_size, [&](int begin, int end, int)
+                 {
+                     const int *flat = block_neighbors[begin / block_size].data();
+                     for (int k = begin; k < end; k++)
+                     {
+                         int i = order[k];
+                         if (is_core[i])
+                             continue;
+                         const int *row = flat + row_begin[i];
+                         int best = -1;
+                         for (int r = 0; r < row_size[i]; r++)
+                         {
+                             if (!is_core[row[r]])
+                                 continue;
+                             int id = labels[row[r]];
+                             if (best == -1 || id < best)
+                                 best = id;
+                         }
+                         labels[i] = best;
+                     }
+                 });
+
+    std::cout << "밀도 적응 DBSCAN 완료! 총 " << cluster_id << "개 클러스터" << std::endl;
+
+    return labels;
+}
+
+std::vector<bool> dbscan_largest_cluster(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    float radius,
+    int min_points)
+{
+    int n = points.size();
+
+    std::cout << "최대 클러스터 DBSCAN 시작..." << std::endl;
+
+    // 1. 점별 이웃 수 (병렬 패킷 탐색)
+    std::vector<int> order = tree.spatial_order();
+    std::vector<int> density(n);
+    parallel_for(0, n, 4096, [&](int begin, int end, int)
+                 {
+                     Point3D targets[KDTREE_PACKET_SIZE];
+                     int counts[KDTREE_PACKET_SIZE];
+                     for (int start = begin; start < end; start += KDTREE_PACKET_SIZE)
+                     {
+                         int count = std::min(end - start, KDTREE_PACKET_SIZE);
+                         for (int q = 0; q < count; q++)
+                         {
+                             targets[q] = points[order[start + q]];
+                         }
+
+                         tree.count_radius_packet(targets, count, radius, counts);
+
+                         for (int q = 0; q < count; q++)
+                         {
+                             density[order[start + q]] = counts[q];
+                         }
+                     }
+                 });
+
+    // 2. 코어 점을 밀도 내림차순으로 시드 후보 정렬
+    std::vector<int> seeds;
+    for (int i = 0; i < n; i++)
+    {
+        if (density[i] >= min_points)
+            seeds.push_back(i);
+    }
+    std::stable_sort(seeds.begin(), seeds.end(),
+                     [&](int a, int b)
+                     {
+                         return density[a] > density[b];
+                     });
+
+    // 3. 시드부터 클러스터 확장
+    // visited: 코어는 확장됨, 경계점은 현재 클러스터에 포함됨 (레벨 안에서 스레드끼리 선점)
+    std::unique_ptr<std::atomic<char>[]> visited(new std::atomic<char>[n]);
+    for (int i = 0; i < n; i++)
+    {
+        visited[i].store(0, std::memory_order_relaxed);
+    }
+
+    int threads = worker_count();
+    std::vector<std::vector<int>> thread_members(threads), thread_next(threads);
+    std::vector<int> members, best;
+    std::vector<int> frontier;
+    int visited_cores = 0;
+    int cluster_count = 0;
+
+    for (int seed : seeds)
+    {
+        // 아직 확장 안 된 점은 다른 클러스터의 경계점이 될 수 있어도 최대 n - visited_cores개
+        if ((int)best.size() >= n - visited_cores)
+            break;
+        if (visited[seed].load(std::memory_order_relaxed))
+            continue;
+
+        members.assign(1, seed);
+        frontier.assign(1, seed);
+        visited[seed].store(1, std::memory_order_relaxed);
+        visited_cores++;
+
+        // 레벨 단위 BFS, 프런티어가 크면 병렬로 탐색
+        while (!frontier.empty())
+        {
+            int chunk = std::max(4 * KDTREE_PACKET_SIZE, (int)frontier.size() / (4 * threads));
+            parallel_for(0, frontier.size(), chunk, [&](int begin, int end, int thread_id)
+                         {
+                             Point3D targets[KDTREE_PACKET_SIZE];
+                             std::vector<int> batch_neighbors[KDTREE_PACKET_SIZE];
+                             std::vector<int> &local_members = thread_members[thread_id];
+                             std::vector<int> &local_next = thread_next[thread_id];
+
+                             for (int start = begin; start < end; start += KDTREE_PACKET_SIZE)
+                             {
+                                 int count = std::min(end - start, KDTREE_PACKET_SIZE);
+                                 for (int q = 0; q < count; q++)
+                                 {
+                                     targets[q] = points[frontier[start + q]];
+                                 }
+
+                                 tree.find_radius_packet(targets, count, radius, batch_neighbors);
+
+                                 for (int q = 0; q < count; q++)
+                                 {
+                                     for (int neighbor : batch_neighbors[q])
+                                     {
+                                         if (visited[neighbor].load(std::memory_order_relaxed) ||
+                                             visited[neighbor].exchange(1, std::memory_order_relaxed))
+                                             continue;
+
+                                         local_members.push_back(neighbor);
+                                         if (density[neighbor] >= min_points)
+                                         {
+                                             local_next.push_back(neighbor);
+                                         }
+                                     }
+                                     batch_neighbors[q].clear();
+                                 }
+                             }
+                         });
+
+            frontier.clear();
+            for (int t = 0; t < threads; t++)
+            {
+                members.insert(members.end(), thread_members[t].begin(), thread_members[t].end());
+                frontier.insert(frontier.end(), thread_next[t].begin(), thread_next[t].end());
+                thread_members[t].clear();
+                thread_next[t].clear();
+            }
+            visited_cores += frontier.size();
+        }
+
+        // 경계점은 다음 클러스터에서도 포함될 수 있도록 방문 표시 해제
+        for (int p : members)
+        {
+            if (density[p] < min_points)
+                visited[p].store(0, std::memory_order_relaxed);
+        }
+
+        if (members.size() > best.size())
+        {
+            best.swap(members);
+        }
+        cluster_count++;
+    }
+
+    std::vector<bool> mask(n, false);
+    for (int p : best)
+    {
+        mask[p] = true;
+    }
+
+    std::cout << "최대 클러스터 DBSCAN 완료! " << cluster_count << "개 클러스터 확장, 최대 "
+              << best.size() << "개 점" << std::endl;
+
+    return mask;
+}
+
+// ==================== OPTICS ====================
+
+OpticsResult compute_optics(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    float max_epsilon,
+    int min_points)
+{
+    int n = points.size();
+    const float undefined = std::numeric_limits<float>::infinity();
+
+    OpticsResult optics;
+    optics.max_epsilon = max_epsilon;
+    optics.min_points = min_points;
+    optics.order.reserve(n);
+    optics.reachability.assign(n, undefined);
+    optics.core_distance.assign(n, undefined);
+    optics.border_reach.assign(n, undefined);
+    optics.border_parent.assign(n, -1);
+
+    std::cout << "OPTICS 계산 시작... (최대 Epsilon: " << max_epsilon << ")" << std::endl;
+
+    // 1. 코어 거리: max_epsilon 안 이웃 중 min_points번째로 가까운 거리 (자신 포함, 병렬)
+    //    코어 거리 <= epsilon 이면 find_radius(epsilon) 개수 >= min_points 와 같음
+    parallel_for(0, n, 1024, [&](int begin, int end, int)
+                 {
+                     std::vector<float> dists;
+                     for (int i = begin; i < end; i++)
+                     {
+                         std::vector<int> neighbors = tree.find_radius(points[i], max_epsilon);
+                         if ((int)neighbors.size() < min_points || min_points < 1)
+                             continue;
+
+                         dists.clear();
+                         for (int neighbor : neighbors)
+                         {
+                             float dx = points[neighbor].x - points[i].x;
+                             float dy = points[neighbor].y - points[i].y;
+                             float dz = points[neighbor].z - points[i].z;
+                             dists.push_back(std::sqrt(dx * dx + dy * dy + dz * dz));
+                         }
+                         std::nth_element(dists.begin(), dists.begin() + (min_points - 1), dists.end());
+                         optics.core_distance[i] = dists[min_points - 1];
+                     }
+                 });
+
+    // 2. 경계점 정보: epsilon에서 코어인 이웃이 epsilon 안에 있으면 경계점
+    //    (순서 스캔만으로는 먼저 처리된 경계점을 놓치므로 따로 저장)
+    parallel_for(0, n, 1024, [&](int begin, int end, int)
+                 {
+                     for (int i = begin; i < end; i++)
+                     {
+                         std::vector<int> neighbors = tree.find_radius(points[i], max_epsilon);
+                         for (int neighbor : neighbors)
+                         {
+                             float core_dist = optics.core_distance[neighbor];
+                             if (neighbor == i || core_dist == undefined)
+                                 continue;
+
+                             float dx = points[neighbor].x - points[i].x;
+                             float dy = points[neighbor].y - points[i].y;
+                             float dz = points[neighbor].z - points[i].z;
+                             float reach = std::max(core_dist, std::sqrt(dx * dx + dy * dy + dz * dz));
+
+                             if (reach < optics.border_reach[i] ||
+                                 (reach == optics.border_reach[i] && neighbor < optics.border_parent[i]))
+                             {
+                                 optics.border_reach[i] = reach;
+                                 optics.border_parent[i] = neighbor;
+                             }
+                         }
+                     }
+                 });
+
+    // 3. 도달 거리 순서 (직렬, 가장 작은 도달 거리 점부터 확장)
+    std::vector<char> processed(n, 0);
+    typedef std::pair<float, int> Seed; // (도달 거리, 점)
+    std::priority_queue<Seed, std::vector<Seed>, std::greater<Seed>> seeds;
+
+    auto expand = [&](int p)
+    {
+        std::vector<int> neighbors = tree.find_radius(points[p], max_epsilon);
+        float core_dist = optics.core_distance[p];
+
+        for (int neighbor : neighbors)
+        {
+            if (processed[neighbor])
+                continue;
+
+            float dx = points[neighbor].x - points[p].x;
+            float dy = points[neighbor].y - points[p].y;
+            float dz = points[neighbor].z - points[p].z;
+            float reach = std::max(core_dist, std::sqrt(dx * dx + dy * dy + dz * dz));
+
+            if (reach < optics.reachability[neighbor])
+            {
+                optics.reachability[neighbor] = reach;
+                seeds.push(Seed(reach, neighbor)); // 이전 항목은 꺼낼 때 무시
+            }
+        }
+    };
+
+    for (int i = 0; i < n; i++)
+    {
+        if (processed[i])
+            continue;
+
+        processed[i] = 1;
+        optics.order.push_back(i);
+
+        if (optics.core_distance[i] == undefined)
+            continue;
+
+        expand(i);
+
+        while (!seeds.empty())
+        {
+            Seed seed = seeds.top();
+            seeds.pop();
+
+            int q = seed.second;
+            if (processed[q] || seed.first > optics.reachability[q])
+                continue; // 이미 처리됐거나 갱신 전 항목
+
+            processed[q] = 1;
+            optics.order.push_back(q);
+
+            if (optics.core_distance[q] != undefined)
+            {
+                expand(q);
+            }
+        }
+
+        // 진행 상황
+        if (i % 100000 == 0)
+        {
+            std::cout << "  진행: " << optics.order.size() << " / " << n << std::endl;
+        }
+    }
+
+    std::cout << "OPTICS 완료!" << std::endl;
+
+    return optics;
+}
+
+std::vector<int> extract_dbscan_labels(const OpticsResult &optics, float epsilon)
+{
+    std::vector<int> labels(optics.reachability.size(), -1);
+    int cluster_id = -1;
+
+    for (int p : optics.order)
+    {
+        if (optics.reachability[p] > epsilon)
+        {
+            // 앞 점들에서 도달 불가 -> 코어면 새 클러스터 시작
+            if (optics.core_distance[p] <= epsilon)
+            {
+                cluster_id++;
+                labels[p] = cluster_id;
+            }
+        }
+        else
+        {
+            labels[p] = cluster_id;
+        }
+    }
+
+    // 순서상 코어 이웃보다 먼저 처리된 경계점 보정
+    for (size_t p = 0; p < labels.size(); p++)
+    {
+        if (labels[p] == -1 && optics.border_reach[p] <= epsilon)
+        {
+            labels[p] = labels[optics.border_parent[p]];
+        }
+    }
+
+    return labels;
+}
+size_t NeighborGraph::memory_bytes() const
+{
+    return offsets.capacity() * sizeof(long long) +
+           neighbors.capacity() * sizeof(int) +
+           distances.capacity() * sizeof(float);
+}
+
+NeighborGraph build_neighbor_graph(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    float epsilon,
+    size_t max_bytes)
+{
+    int n = points.size();
+    NeighborGraph graph;
+    graph.epsilon = epsilon;
+    graph.offsets.assign(n + 1, 0);
+
+    std::vector<int> order = tree.spatial_order();
+
+    // 1. 점별 이웃 수 -> 행 시작 위치
+    parallel_for(0, n, 4096, [&](int begin, int end, int)
+                 {
+                     Point3D targets[KDTREE_PACKET_SIZE];
+                     int counts[KDTREE_PACKET_SIZE];
+                     for (int start = begin; start < end; start += KDTREE_PACKET_SIZE)
+                     {
+                         int count = std::min(end - start, KDTREE_PACKET_SIZE);
+                         for (int q = 0; q < count; q++)
+                         {
+                             targets[q] = points[order[start + q]];
+                         }
+
+                         tree.count_radius_packet(targets, count, epsilon, counts);
+
+                         for (int q = 0; q < count; q++)
+                         {
+                             graph.offsets[order[start + q] + 1] = counts[q];
+                         }
+                     }
+                 });
+
+    for (int i = 0; i < n; i++)
+    {
+        graph.offsets[i + 1] += graph.offsets[i];
+    }
+
+    // 간선 배열을 할당하기 전에 예산 확인
+    size_t edges = graph.offsets[n];
+    size_t bytes = (size_t)(n + 1) * sizeof(long long) + edges * (sizeof(int) + sizeof(float));
+    if (max_bytes > 0 && bytes > max_bytes)
+    {
+        std::cout << "이웃 그래프 " << bytes / (1024.0 * 1024.0) << " MB가 예산 " << max_bytes / (1024.0 * 1024.0)
+                  << " MB를 넘어 구축하지 않음" << std::endl;
+        return NeighborGraph();
+    }
+
+    graph.neighbors.resize(edges);
+    graph.distances.resize(edges);
+
+    // 2. 행 채우기 (거리 오름차순 정렬)
+    parallel_for(0, n, 4096, [&](int begin, int end, int)
+                 {
+                     Point3D targets[KDTREE_PACKET_SIZE];
+                     std::vector<int> neighbors[KDTREE_PACKET_SIZE];
+                     std::vector<std::pair<float, int>> row;
+
+                     for (int start = begin; start < end; start += KDTREE_PACKET_SIZE)
+                     {
+                         int count = std::min(end - start, KDTREE_PACKET_SIZE);
+                         for (int q = 0; q < count; q++)
+                         {
+                             targets[q] = points[order[start + q]];
+                             neighbors[q].clear();
+                         }
+
+                         tree.find_radius_packet(targets, count, epsilon, neighbors);
+
+                         for (int q = 0; q < count; q++)
+                         {
+                             const Point3D &p = targets[q];
+                             row.clear();
+                             for (int neighbor : neighbors[q])
+                             {
+                                 // KDTree::distance와 같은 식 (작은 반경 필터링이 트리 탐색과 일치하도록)
+                                 float dx = p.x - points[neighbor].x;
+                                 float dy = p.y - points[neighbor].y;
+                                 float dz = p.z - points[neighbor].z;
+                                 row.push_back({std::sqrt(dx * dx + dy * dy + dz * dz), neighbor});
+                             }
+                             std::sort(row.begin(), row.end());
+
+                             long long offset = graph.offsets[order[start + q]];
+                             for (size_t k = 0; k < row.size(); k++)
+                             {
+                                 graph.distances[offset + k] = row[k].first;
+                                 graph.neighbors[offset + k] = row[k].second;
+                             }
+                         }
+                     }
+                 });
+
+    return graph;
+}
+
+std::vector<int> dbscan_clustering_graph(
+    const NeighborGraph &graph,
+    float radius,
+    int min_points)
+{
+    int n = (int)graph.offsets.size() - 1;
+    std::vector<int> labels(n, -1);
+
+    // 행별 radius 이내 이웃 끝 위치 (거리 오름차순이라 이진 탐색)
+    std::vector<long long> row_end(n);
+    std::vector<char> is_core(n, 0);
+    parallel_for(0, n, 65536, [&](int begin, int end, int)
+                 {
+                     for (int i = begin; i < end; i++)
+                     {
+                         const float *first = graph.distances.data() + graph.offsets[i];
+                         const float *last = graph.distances.data() + graph.offsets[i + 1];
+                         row_end[i] = graph.offsets[i] + (std::upper_bound(first, last, radius) - first);
+                         is_core[i] = row_end[i] - graph.offsets[i] >= min_points;
+                     }
+                 });
+
+    // 인덱스 순으로 시드를 잡아 확장 (직렬 DBSCAN과 같은 번호/경계점 배정)
+    int cluster_id = 0;
+    std::vector<int> frontier;
+    for (int i = 0; i < n; i++)
+    {
+        if (!is_core[i] || labels[i] != -1)
+            continue;
+
+        labels[i] = cluster_id;
+        frontier.assign(1, i);
+
+        while (!frontier.empty())
+        {
+            int p = frontier.back();
+            frontier.pop_back();
+
+            for (long long k = graph.offsets[p]; k < row_end[p]; k++)
+            {
+                int neighbor = graph.neighbors[k];
+                if (labels[neighbor] != -1)
+                    continue;
+
+                labels[neighbor] = cluster_id;
+                if (is_core[neighbor])
+                {
+                    frontier.push_back(neighbor);
+                }
+            }
+        }
+
+        cluster_id++;
+    }
+
+    return labels;
+}
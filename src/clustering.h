@@ -5,12 +5,22 @@
 #include <vector>
 #include <string>
 
+// 클러스터 통계 (analyze_clusters)
 struct ClusterInfo
 {
     int id;
     int size;
     Point3D center;
-    float radius;
+    float radius; // 중심에서 가장 먼 점까지 거리 (compute_extents일 때만, 아니면 -1)
+
+    Point3D aabb_min, aabb_max;
+    float covariance[6]; // xx, xy, xz, yy, yz, zz
+
+    // PCA 방향 박스 (주축은 분산 큰 순서의 단위 벡터, 오른손 좌표계)
+    Point3D axes[3];
+    float variances[3];
+    Point3D obb_center;
+    Point3D obb_half_extent; // 주축 방향 반길이
 };
 
 std::vector<int> dbscan_clustering_kdtree(
@@ -19,9 +29,138 @@ std::vector<int> dbscan_clustering_kdtree(
     float radius,
     int min_points);
 
+// 반경별 코어 점 비율 (epsilon 튜닝용, 점별 곡선은 저장하지 않음)
+std::vector<float> core_ratio_curve(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    const std::vector<float> &radii,
+    int min_points);
+
+// k-거리 곡선 (epsilon 추천용)
+struct KDistanceCurve
+{
+    int k = 0;
+    std::vector<float> distances; // 표본 점별 k번째 이웃 거리 (자신 포함), 오름차순
+    int knee_index = -1;          // 무릎 위치 (distances 인덱스)
+    float suggested_epsilon = 0.0f;
+};
+
+// 점의 sample_ratio 비율(등간격 표본)에 대해 k번째 이웃 거리를 병렬로 계산해 정렬
+// 무릎 = 정규화한 곡선이 양 끝을 잇는 직선에서 가장 멀리 떨어진 지점 (Kneedle)
+// 거리가 큰 상위 1% 꼬리는 직선 끝점에서 제외 (이상치 몇 개가 무릎을 끝으로 미는 것 방지)
+// k = min_points이면 suggested_epsilon에서 표본의 knee_index + 1개가 코어
+KDistanceCurve compute_k_distance_curve(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    int k,
+    float sample_ratio);
+
+// 병렬 DBSCAN (코어 판정 -> lock-free union-find로 코어 연결 -> 경계점 배정)
+// 클러스터 번호와 경계점 배정 규칙이 dbscan_clustering_kdtree와 같아서 결과 레이블이 동일
+std::vector<int> dbscan_clustering_parallel(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    float radius,
+    int min_points);
+
+// 격자 기반 정확 DBSCAN (셀 한 변 = radius/√3 -> 같은 셀의 두 점은 항상 radius 이내)
+// 점이 min_points개 이상인 셀은 이웃 탐색 없이 전부 코어, 인접 셀끼리만 비교
+// 레이블은 dbscan_clustering_kdtree와 동일, 격자가 너무 크면 tree로 병렬 DBSCAN 실행
+// core_flags를 주면 점별 코어 여부도 채움
+std::vector<int> dbscan_clustering_grid(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    float radius,
+    int min_points,
+    std::vector<char> *core_flags = nullptr);
+
+// 밀도 적응 DBSCAN용 점별 국소 거리 (트리 순서 블록으로 병렬 계산, 한 번 계산해 캐시)
+// = 점의 k-최근접 이웃들의 k번째 이웃 거리 중앙값 (점이 k개보다 적으면 -1)
+// 자기 k-거리 대신 이웃의 값을 써서 밀집 면 옆 노이즈가 큰 반경을 갖지 않음
+std::vector<float> compute_local_scales(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    int k);
+
+// 밀도 적응 DBSCAN: 점 i의 반경 r_i = min(scale * local_scales[i], max_radius)
+// 두 점은 거리 <= min(r_p, r_q)일 때 이웃 (대칭 관계라 코어 연결과 경계점 배정은 일반 DBSCAN과 같음)
+// 스캐너 근처 밀집 영역은 반경이 작아 주변 노이즈가 붙지 않고, 먼 희박한 벽은 max_radius까지 반경이 커짐
+// 트리 탐색은 점마다 한 번 (코어는 번호가 큰 이웃, 나머지는 모든 이웃을 저장해 연결/경계점 단계에서 재사용)
+std::vector<int> dbscan_clustering_adaptive(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    const std::vector<float> &local_scales,
+    float scale,
+    float max_radius,
+    int min_points);
+
+// 가장 큰 클러스터만 찾는 DBSCAN (결과: 점별 포함 여부)
+// 밀도가 높은 코어 점부터 확장하고, 남은 미방문 코어로 더 큰 클러스터가 나올 수 없으면 중단
+// 다른 클러스터는 레이블을 매기지 않음. 두 클러스터에 걸친 경계점은 포함 (dbscan_clustering_kdtree는 번호가 작은 쪽에 배정)
+std::vector<bool> dbscan_largest_cluster(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    float radius,
+    int min_points);
+
+// OPTICS 결과: max_epsilon 이하의 어떤 epsilon이든 DBSCAN 레이블을 선형 스캔으로 추출
+struct OpticsResult
+{
+    float max_epsilon;
+    int min_points;
+    std::vector<int> order;            // 처리 순서
+    std::vector<float> reachability;   // 점별 도달 거리 (정의 안 되면 무한대)
+    std::vector<float> core_distance;  // 점별 코어 거리 (max_epsilon 안에 min_points개 없으면 무한대)
+    std::vector<float> border_reach;   // min(max(이웃 코어 거리, 이웃까지 거리)) -> 경계점 판정용
+    std::vector<int> border_parent;    // border_reach를 만든 이웃 (경계점이 따라갈 코어 점)
+};
+
+// 코어 거리(병렬)와 도달 거리 순서를 max_epsilon까지 한 번 계산
+OpticsResult compute_optics(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    float max_epsilon,
+    int min_points);
+
+// epsilon(<= max_epsilon)에 대한 DBSCAN 레이블 (클러스터 번호와 여러 클러스터에 걸친 경계점 배정만 다를 수 있음)
+std::vector<int> extract_dbscan_labels(const OpticsResult &optics, float epsilon);
+
+// epsilon 이웃 그래프 (CSR): 점 i의 이웃 = neighbors[offsets[i] ~ offsets[i + 1]), 거리 오름차순
+// epsilon 이하의 어떤 반경이든 행 앞부분만 보면 되므로 MinPts 변경이나 더 작은 epsilon에 재사용
+struct NeighborGraph
+{
+    float epsilon = 0.0f;
+    std::vector<long long> offsets; // 점 개수 + 1 (간선 수가 int를 넘을 수 있음)
+    std::vector<int> neighbors;     // 자신 포함
+    std::vector<float> distances;   // neighbors와 같은 위치의 거리
+
+    bool empty() const { return offsets.empty(); }
+    size_t memory_bytes() const;
+};
+
+// 모든 점의 epsilon 이웃을 병렬로 계산해 CSR로 저장
+// 이웃 수를 먼저 세어 그래프 크기가 max_bytes(0이면 제한 없음)를 넘으면 할당하지 않고 빈 그래프 반환
+NeighborGraph build_neighbor_graph(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    float epsilon,
+    size_t max_bytes = 0);
+
+// 저장된 그래프로 DBSCAN (radius <= graph.epsilon, 트리 탐색 없음)
+// 레이블은 dbscan_clustering_kdtree와 동일
+std::vector<int> dbscan_clustering_graph(
+    const NeighborGraph &graph,
+    float radius,
+    int min_points);
+
+// 레이블별 통계 (노이즈 -1도 하나의 항목), 크기 내림차순
+// 점을 한 번만 병렬로 읽으며 스레드별 누적 (메모리는 클러스터 수 x 스레드 수)
+// compute_extents = false: OBB 반길이는 AABB를 주축에 투영한 값 (점을 모두 포함하지만 느슨함)
+// compute_extents = true: 두 번째 SIMD 패스로 최대 반경과 딱 맞는 OBB 계산
 std::vector<ClusterInfo> analyze_clusters(
     const std::vector<Point3D> &points,
-    const std::vector<int> &labels);
+    const std::vector<int> &labels,
+    bool compute_extents = false);
 
 #endif
 
@@ -1,4 +1,5 @@
 #include "floor.h"
+#include "parallel.h"
 #include <cmath>
 #include <cstdlib>
 #include <ctime>
@@ -57,6 +58,8 @@ std::vector<Point3D> get_floor_points(
 
 FloorRemovalResult remove_floor_with_column_protection(
     const std::vector<Point3D> &points,
+    KDTree &tree,
+    const std::vector<bool> &active,
     float floor_ratio,
     float search_radius,
     float mid_start,
@@ -65,19 +68,28 @@ FloorRemovalResult remove_floor_with_column_protection(
 {
     FloorRemovalResult result;
 
-    if (points.empty())
+    // 활성 점 중 첫 번째
+    size_t first = 0;
+    while (first < points.size() && !active[first])
+    {
+        first++;
+    }
+
+    if (first == points.size())
     {
         return result;
     }
 
     std::cout << "\n=== 수직 기둥 보호 바닥 제거 ===" << std::endl;
 
-    // 1. Y 범위 계산
-    float y_min = points[0].y, y_max = points[0].y;
-    for (const auto &p : points)
+    // 1. Y 범위 계산 (활성 점만)
+    float y_min = points[first].y, y_max = points[first].y;
+    for (size_t i = first; i < points.size(); i++)
     {
-        y_min = std::min(y_min, p.y);
-        y_max = std::max(y_max, p.y);
+        if (!active[i])
+            continue;
+        y_min = std::min(y_min, points[i].y);
+        y_max = std::max(y_max, points[i].y);
     }
 
     float range = y_max - y_min;
@@ -91,26 +103,82 @@ FloorRemovalResult remove_floor_with_column_protection(
     std::cout << "  검색 반경 (XZ): " << search_radius << std::endl;
     std::cout << "  최소 점 개수: " << min_points_above << std::endl;
 
-    // 2. 중간 높이 점들만 추출
-    std::vector<Point3D> mid_points;
-    for (const auto &p : points)
+    // 2. 중간 높이 활성 점만 남긴 필터 (트리는 다시 만들지 않음)
+    std::vector<bool> mid_active(points.size(), false);
+    int mid_count = 0;
+    for (size_t i = 0; i < points.size(); i++)
     {
-        if (p.y >= mid_y_start && p.y <= mid_y_end)
+        if (active[i] && points[i].y >= mid_y_start && points[i].y <= mid_y_end)
         {
-            mid_points.push_back(p);
+            mid_active[i] = true;
+            mid_count++;
         }
     }
-    std::cout << "  중간 높이 점 개수: " << mid_points.size() << std::endl;
+    std::cout << "  중간 높이 점 개수: " << mid_count << std::endl;
+
+    // 3. 중간 높이 필터 생성
+    KDTreeFilter mid_filter = tree.make_filter(mid_active);
+
+    // 4. 바닥 점들의 중간 높이 이웃 수를 패킷 탐색으로 미리 계산
+    //    (XZ 격자 순서로 정렬해서 공간적으로 가까운 쿼리끼리 묶음)
+    std::vector<int> floor_indices;
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        if (active[i] && points[i].y <= floor_y_max)
+        {
+            floor_indices.push_back(i);
+        }
+    }
+
+    float cell = search_radius > 0 ? search_radius : 1.0f;
+    std::sort(floor_indices.begin(), floor_indices.end(),
+              [&points, cell](int a, int b)
+              {
+                  float ax = std::floor(points[a].x / cell);
+                  float bx = std::floor(points[b].x / cell);
+                  if (ax != bx)
+                      return ax < bx;
+                  return std::floor(points[a].z / cell) < std::floor(points[b].z / cell);
+              });
+
+    std::vector<int> mid_counts(points.size(), 0);
+    Point3D targets[KDTREE_PACKET_SIZE];
+    int counts[KDTREE_PACKET_SIZE];
+
+    task_begin_stage(floor_indices.size());
+    for (size_t start = 0; start < floor_indices.size(); start += KDTREE_PACKET_SIZE)
+    {
+        // 백그라운드 작업이 취소되면 중단 (결과는 버려짐)
+        if (start % 4096 == 0)
+        {
+            task_set_progress(start);
+            if (task_cancelled())
+                return result;
+        }
+
+        int count = std::min((int)(floor_indices.size() - start), KDTREE_PACKET_SIZE);
+        for (int q = 0; q < count; q++)
+        {
+            targets[q] = points[floor_indices[start + q]];
+        }
 
-    // 3. 중간 높이 점들로 KD-Tree 생성
-    KDTree mid_tree(mid_points);
-    std::cout << "  중간 높이 KD-Tree 생성 완료" << std::endl;
+        // 3D 반경 안의 점은 XZ 거리도 반경 이내이므로 XZ 재검사는 필요 없음
+        tree.count_radius_packet(targets, count, search_radius, counts, &mid_filter);
+
+        for (int q = 0; q < count; q++)
+        {
+            mid_counts[floor_indices[start + q]] = counts[q];
+        }
+    }
 
     int floor_count = 0;
     int removed_count = 0;
 
     for (size_t i = 0; i < points.size(); i++)
     {
+        if (!active[i])
+            continue;
+
         const Point3D &p = points[i];
 
         // 바닥 영역이 아니면 무조건 유지
@@ -122,24 +190,8 @@ FloorRemovalResult remove_floor_with_column_protection(
 
         floor_count++;
 
-        // 4. 중간 높이 KD-Tree에서 XZ 반경으로 검색
-        std::vector<int> neighbors = mid_tree.find_radius(p, search_radius);
-
-        // 5. XZ 거리만 다시 체크 (Y는 이미 mid_points에서 필터링됨)
-        int points_in_mid = 0;
-        for (int idx : neighbors)
-        {
-            const Point3D &other = mid_points[idx];
-
-            float dx = other.x - p.x;
-            float dz = other.z - p.z;
-            float xz_dist = std::sqrt(dx * dx + dz * dz);
-
-            if (xz_dist <= search_radius)
-            {
-                points_in_mid++;
-            }
-        }
+        // 5. 중간 높이 활성 점 중 반경 안의 이웃 수
+        int points_in_mid = mid_counts[i];
 
         // 중간 높이에 점이 충분히 많으면 유지 (기둥 아래)
         if (points_in_mid >= min_points_above)
@@ -165,4 +217,99 @@ FloorRemovalResult remove_floor_with_column_protection(
     std::cout << "  남은 점: " << result.filtered.size() << std::endl;
 
     return result;
+}
+
+std::vector<float> floor_removal_curve(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    const std::vector<bool> &active,
+    const std::vector<float> &radii,
+    float floor_ratio,
+    float mid_start,
+    float mid_end,
+    int min_points_above)
+{
+    int radius_count = radii.size();
+    std::vector<float> ratios(radius_count, 0.0f);
+
+    size_t first = 0;
+    while (first < points.size() && !active[first])
+    {
+        first++;
+    }
+
+    if (first == points.size() || radius_count == 0)
+    {
+        return ratios;
+    }
+
+    // Y 범위 (remove_floor_with_column_protection과 동일)
+    float y_min = points[first].y, y_max = points[first].y;
+    for (size_t i = first; i < points.size(); i++)
+    {
+        if (!active[i])
+            continue;
+        y_min = std::min(y_min, points[i].y);
+        y_max = std::max(y_max, points[i].y);
+    }
+
+    float range = y_max - y_min;
+    float floor_y_max = y_min + range * floor_ratio;
+    float mid_y_start = y_min + range * mid_start;
+    float mid_y_end = y_min + range * mid_end;
+
+    std::vector<bool> mid_active(points.size(), false);
+    std::vector<int> floor_indices;
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        if (!active[i])
+            continue;
+        if (points[i].y >= mid_y_start && points[i].y <= mid_y_end)
+        {
+            mid_active[i] = true;
+        }
+        if (points[i].y <= floor_y_max)
+        {
+            floor_indices.push_back(i);
+        }
+    }
+
+    if (floor_indices.empty())
+    {
+        return ratios;
+    }
+
+    KDTreeFilter mid_filter = tree.make_filter(mid_active);
+
+    // 스레드별 제거 개수
+    std::vector<std::vector<int>> removed(worker_count(), std::vector<int>(radius_count, 0));
+
+    parallel_for(0, (int)floor_indices.size(), 4096, [&](int begin, int end, int thread_id)
+                 {
+                     std::vector<int> counts(radius_count);
+                     std::vector<int> &local = removed[thread_id];
+                     for (int i = begin; i < end; i++)
+                     {
+                         tree.count_radius_multi(points[floor_indices[i]], radii, counts.data(), &mid_filter);
+                         for (int k = 0; k < radius_count; k++)
+                         {
+                             if (counts[k] < min_points_above)
+                                 local[k]++;
+                         }
+                     }
+                 });
+
+    for (const auto &local : removed)
+    {
+        for (int k = 0; k < radius_count; k++)
+        {
+            ratios[k] += local[k];
+        }
+    }
+    for (float &r : ratios)
+    {
+        r /= floor_indices.size();
+    }
+
+    return ratios;
 }
\ No newline at end of file
@@ -34,7 +34,7 @@ struct Plane
 struct FloorRemovalResult
 {
     std::vector<Point3D> filtered;    // 유지된 점들
-    std::vector<int> removed_indices; // 제거된 점들의 인덱스
+    std::vector<int> removed_indices; // 제거된 점들의 인덱스 (points 기준)
 };
 
 // 바닥 영역 점들만 추출 (시각화용)
@@ -42,12 +42,27 @@ std::vector<Point3D> get_floor_points(
     const std::vector<Point3D> &points,
     float floor_ratio = 0.15f);
 
+// active인 점만 대상으로 바닥 제거, 중간 높이 탐색은 points 전체로 만든 tree를 필터로 재사용
 FloorRemovalResult remove_floor_with_column_protection(
     const std::vector<Point3D> &points,
+    KDTree &tree,
+    const std::vector<bool> &active,
     float floor_ratio = 0.15f,
     float search_radius = 0.1f,
     float mid_start = 0.10f,
     float mid_end = 0.40f,
     int min_points_above = 30);
 
+// search_radius 후보(오름차순)별 바닥 점 제거 비율 (파라미터 튜닝용)
+// 바닥 점마다 중간 높이 필터로 트리를 한 번만 순회해서 모든 반경을 계산
+std::vector<float> floor_removal_curve(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    const std::vector<bool> &active,
+    const std::vector<float> &radii,
+    float floor_ratio = 0.15f,
+    float mid_start = 0.10f,
+    float mid_end = 0.40f,
+    int min_points_above = 30);
+
 #endif // RANSAC_H
\ No newline at end of file
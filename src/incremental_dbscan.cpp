@@ -0,0 +1,429 @@
+#include "incremental_dbscan.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+IncrementalDbscan::IncrementalDbscan(float radius, int min_points)
+    : radius(radius), min_points(min_points)
+{
+}
+
+// 축마다 21비트 (원점 기준 ±2^20 셀), 범위를 넘으면 다른 셀과 키가 겹치지만 거리 검사를 하므로 결과는 같음
+uint64_t IncrementalDbscan::cell_key(int ix, int iy, int iz) const
+{
+    const uint64_t mask = (1 << 21) - 1;
+    return ((uint64_t)(ix + (1 << 20)) & mask) << 42 |
+           ((uint64_t)(iy + (1 << 20)) & mask) << 21 |
+           ((uint64_t)(iz + (1 << 20)) & mask);
+}
+
+uint64_t IncrementalDbscan::cell_of(const Point3D &p) const
+{
+    return cell_key((int)std::floor(p.x / radius), (int)std::floor(p.y / radius), (int)std::floor(p.z / radius));
+}
+
+void IncrementalDbscan::find_neighbors(int i, std::vector<int> &out) const
+{
+    out.clear();
+    const Point3D &p = points[i];
+    int ix = (int)std::floor(p.x / radius);
+    int iy = (int)std::floor(p.y / radius);
+    int iz = (int)std::floor(p.z / radius);
+
+    for (int dx = -1; dx <= 1; dx++)
+        for (int dy = -1; dy <= 1; dy++)
+            for (int dz = -1; dz <= 1; dz++)
+            {
+                auto it = cells.find(cell_key(ix + dx, iy + dy, iz + dz));
+                if (it == cells.end())
+                    continue;
+
+                for (const CellEntry &e : it->second)
+                {
+                    // KDTree::distance와 같은 식 (정적 DBSCAN과 결과가 일치하도록)
+                    float ddx = p.x - e.x;
+                    float ddy = p.y - e.y;
+                    float ddz = p.z - e.z;
+                    if (std::sqrt(ddx * ddx + ddy * ddy + ddz * ddz) <= radius)
+                        out.push_back(e.id);
+                }
+            }
+}
+
+int IncrementalDbscan::new_node()
+{
+    parent.push_back(parent.size());
+    cluster_size.push_back(1);
+    return parent.size() - 1;
+}
+
+int IncrementalDbscan::find_root(int node)
+{
+    while (parent[node] != node)
+    {
+        parent[node] = parent[parent[node]];
+        node = parent[node];
+    }
+    return node;
+}
+
+void IncrementalDbscan::unite(int a, int b)
+{
+    a = find_root(node_of[a]);
+    b = find_root(node_of[b]);
+    if (a == b)
+        return;
+
+    if (cluster_size[a] < cluster_size[b])
+        std::swap(a, b);
+    parent[b] = a;
+    cluster_size[a] += cluster_size[b];
+}
+
+void IncrementalDbscan::resplit(int r, const std::vector<int> &seeds)
+{
+    // 탐색 k: frontier[k]에 방문한 점이 순서대로 쌓이고 head[k]까지 확장됨
+    // 만난 탐색끼리는 group으로 묶음, group이 하나만 남으면 연결 유지 -> 종료
+    std::unordered_map<int, int> owner; // 점 -> 탐색
+    std::vector<std::vector<int>> frontier;
+    std::vector<size_t> head;
+    std::vector<int> group;
+    std::vector<char> done;
+
+    for (int s : seeds)
+    {
+        if (owner.count(s))
+            continue;
+        owner[s] = frontier.size();
+        frontier.push_back({s});
+        head.push_back(0);
+        group.push_back(group.size());
+        done.push_back(0);
+    }
+
+    auto find_group = [&](int k)
+    {
+        while (group[k] != k)
+        {
+            group[k] = group[group[k]];
+            k = group[k];
+        }
+        return k;
+    };
+
+    int searches = frontier.size();
+    int active = searches;
+    std::vector<int> neighbors;
+    while (active > 1)
+    {
+        // 모든 탐색을 한 점씩 번갈아 확장
+        bool progress = false;
+        for (int k = 0; k < searches && active > 1; k++)
+        {
+            if (head[k] >= frontier[k].size())
+                continue;
+
+            int current = frontier[k][head[k]++];
+            progress = true;
+
+            find_neighbors(current, neighbors);
+            for (int q : neighbors)
+            {
+                if (!core[q])
+                    continue;
+
+                auto it = owner.find(q);
+                if (it == owner.end())
+                {
+                    owner[q] = k;
+                    frontier[k].push_back(q);
+                    continue;
+                }
+
+                int a = find_group(k), b = find_group(it->second);
+                if (a != b)
+                {
+                    group[b] = a;
+                    active--;
+                }
+            }
+        }
+
+        if (!progress)
+            break;
+
+        // 모든 탐색이 끝난 group = 완전한 연결 요소 -> 다른 group이 남아 있으면 분리
+        std::vector<char> exhausted(searches, 1);
+        for (int k = 0; k < searches; k++)
+        {
+            if (head[k] < frontier[k].size())
+                exhausted[find_group(k)] = 0;
+        }
+
+        for (int g = 0; g < searches && active > 1; g++)
+        {
+            if (find_group(g) != g || done[g] || !exhausted[g])
+                continue;
+
+            int root = -1;
+            for (int k = 0; k < searches; k++)
+            {
+                if (find_group(k) != g)
+                    continue;
+
+                for (int p : frontier[k])
+                {
+                    node_of[p] = new_node();
+                    if (root == -1)
+                        root = node_of[p];
+                    else
+                    {
+                        parent[node_of[p]] = root;
+                        cluster_size[root]++;
+                    }
+                }
+            }
+            cluster_size[r] -= cluster_size[root];
+            done[g] = 1;
+            active--;
+        }
+    }
+}
+
+int IncrementalDbscan::insert(const std::vector<Point3D> &pts)
+{
+    int first = points.size();
+    int n = first + pts.size();
+
+    points.insert(points.end(), pts.begin(), pts.end());
+    alive.resize(n, 1);
+    core.resize(n, 0);
+    neighbor_count.resize(n, 0);
+    node_of.resize(n, -1);
+
+    for (int i = first; i < n; i++)
+    {
+        const Point3D &p = points[i];
+        cells[cell_of(p)].push_back({p.x, p.y, p.z, i});
+    }
+
+    // 1. 이웃 수 갱신 (새 점끼리는 각자의 탐색에서 세므로 기존 점만 증가)
+    std::vector<int> neighbors, candidates;
+    task_begin_stage(n - first);
+    for (int i = first; i < n; i++)
+    {
+        // 백그라운드 작업이 취소되면 중단 (이웃 수가 일부만 갱신된 상태라 호출한 쪽에서 엔진을 버림)
+        if ((i - first) % 4096 == 0)
+        {
+            task_set_progress(i - first);
+            if (task_cancelled())
+                return first;
+        }
+
+        find_neighbors(i, neighbors);
+        neighbor_count[i] = neighbors.size();
+        candidates.push_back(i);
+
+        for (int q : neighbors)
+        {
+            if (q < first)
+            {
+                neighbor_count[q]++;
+                if (neighbor_count[q] == min_points && !core[q])
+                    candidates.push_back(q);
+            }
+        }
+    }
+
+    // 2. 새 코어 점
+    std::vector<int> new_cores;
+    for (int c : candidates)
+    {
+        if (!core[c] && neighbor_count[c] >= min_points)
+        {
+            core[c] = 1;
+            node_of[c] = new_node();
+            new_cores.push_back(c);
+        }
+    }
+
+    // 3. 새 코어와 이웃 코어 병합
+    for (int c : new_cores)
+    {
+        find_neighbors(c, neighbors);
+        for (int q : neighbors)
+        {
+            if (core[q])
+                unite(c, q);
+        }
+    }
+
+    std::cout << "증분 DBSCAN: " << pts.size() << "개 점 추가, 새 코어 " << new_cores.size() << "개" << std::endl;
+
+    return first;
+}
+
+void IncrementalDbscan::remove(const std::vector<int> &ids)
+{
+    // 1. 격자에서 빼고 이웃 수 감소, 코어를 잃을 수 있는 점 수집
+    std::vector<int> neighbors, candidates;
+    for (int id : ids)
+    {
+        if (id < 0 || id >= (int)points.size() || !alive[id])
+            continue;
+
+        std::vector<CellEntry> &cell = cells[cell_of(points[id])];
+        for (size_t k = 0; k < cell.size(); k++)
+        {
+            if (cell[k].id == id)
+            {
+                cell[k] = cell.back();
+                cell.pop_back();
+                break;
+            }
+        }
+        alive[id] = 0;
+        candidates.push_back(id);
+
+        find_neighbors(id, neighbors);
+        for (int q : neighbors)
+        {
+            neighbor_count[q]--;
+            if (core[q] && neighbor_count[q] < min_points)
+                candidates.push_back(q);
+        }
+    }
+
+    // 2. 코어를 잃은 점: 노드를 버림 (다른 노드의 경로로만 남음)
+    std::vector<int> lost;
+    std::unordered_map<uint64_t, std::vector<int>> lost_cells; // 삭제된 점은 cells에 없으므로 따로 색인
+    for (int c : candidates)
+    {
+        if (!core[c] || (alive[c] && neighbor_count[c] >= min_points))
+            continue;
+
+        cluster_size[find_root(node_of[c])]--;
+        core[c] = 0;
+        node_of[c] = -1;
+        lost.push_back(c);
+        lost_cells[cell_of(points[c])].push_back(c);
+    }
+
+    // 3. 서로 반경 안에 있는 코어 손실점끼리 묶고, 묶음 주변의 남은 코어에서 분리 여부 확인
+    //    (묶음마다 시드가 가까이 모여 있어 탐색이 금방 만나므로 클러스터 전체를 보지 않음)
+    std::unordered_map<int, char> grouped;
+    std::vector<int> component, seeds;
+    int split_checks = 0;
+    for (int c : lost)
+    {
+        if (grouped.count(c))
+            continue;
+
+        grouped[c] = 1;
+        component.assign(1, c);
+        for (size_t k = 0; k < component.size(); k++)
+        {
+            const Point3D &p = points[component[k]];
+            int ix = (int)std::floor(p.x / radius);
+            int iy = (int)std::floor(p.y / radius);
+            int iz = (int)std::floor(p.z / radius);
+            for (int dx = -1; dx <= 1; dx++)
+                for (int dy = -1; dy <= 1; dy++)
+                    for (int dz = -1; dz <= 1; dz++)
+                    {
+                        auto it = lost_cells.find(cell_key(ix + dx, iy + dy, iz + dz));
+                        if (it == lost_cells.end())
+                            continue;
+
+                        for (int q : it->second)
+                        {
+                            float ddx = p.x - points[q].x;
+                            float ddy = p.y - points[q].y;
+                            float ddz = p.z - points[q].z;
+                            if (std::sqrt(ddx * ddx + ddy * ddy + ddz * ddz) <= radius && !grouped.count(q))
+                            {
+                                grouped[q] = 1;
+                                component.push_back(q);
+                            }
+                        }
+                    }
+        }
+
+        // 시드 = 묶음의 살아 있는 코어 이웃, 이미 다른 클러스터로 분리된 시드끼리는 따로 검사
+        seeds.clear();
+        for (int l : component)
+        {
+            find_neighbors(l, neighbors);
+            for (int q : neighbors)
+            {
+                if (core[q])
+                    seeds.push_back(q);
+            }
+        }
+
+        std::vector<std::pair<int, int>> by_root; // (루트, 시드)
+        for (int q : seeds)
+        {
+            by_root.push_back({find_root(node_of[q]), q});
+        }
+        std::sort(by_root.begin(), by_root.end());
+        by_root.erase(std::unique(by_root.begin(), by_root.end()), by_root.end());
+
+        for (size_t begin = 0; begin < by_root.size();)
+        {
+            size_t end = begin;
+            seeds.clear();
+            while (end < by_root.size() && by_root[end].first == by_root[begin].first)
+            {
+                seeds.push_back(by_root[end++].second);
+            }
+
+            if (seeds.size() > 1)
+            {
+                resplit(by_root[begin].first, seeds);
+                split_checks++;
+            }
+            begin = end;
+        }
+    }
+
+    std::cout << "증분 DBSCAN: " << ids.size() << "개 점 삭제, 코어 손실 " << lost.size() << "개, 분리 검사 " << split_checks << "회" << std::endl;
+}
+
+std::vector<int> IncrementalDbscan::labels()
+{
+    int n = points.size();
+    std::vector<int> result(n, -1);
+
+    // 클러스터 번호: 가장 작은 코어 번호 순 (정적 DBSCAN의 시드 순서와 같음)
+    std::unordered_map<int, int> cluster_id;
+    for (int i = 0; i < n; i++)
+    {
+        if (!core[i])
+            continue;
+
+        int r = find_root(node_of[i]);
+        auto it = cluster_id.find(r);
+        if (it == cluster_id.end())
+            it = cluster_id.emplace(r, (int)cluster_id.size()).first;
+        result[i] = it->second;
+    }
+
+    // 경계점: 이웃 코어 중 가장 작은 클러스터 번호
+    std::vector<int> neighbors;
+    for (int i = 0; i < n; i++)
+    {
+        if (!alive[i] || core[i] || neighbor_count[i] <= 1)
+            continue;
+
+        find_neighbors(i, neighbors);
+        for (int q : neighbors)
+        {
+            if (core[q] && (result[i] == -1 || result[q] < result[i]))
+                result[i] = result[q];
+        }
+    }
+
+    return result;
+}
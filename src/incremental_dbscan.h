@@ -0,0 +1,71 @@
+#ifndef INCREMENTAL_DBSCAN_H
+#define INCREMENTAL_DBSCAN_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "point3d.h"
+
+// 점 추가/삭제 시 레이블을 국소적으로 갱신하는 DBSCAN
+// - 공간 색인: 셀 한 변 = radius인 해시 격자 (추가/삭제 O(1), 이웃 탐색은 27개 셀)
+// - 추가: 이웃 점의 이웃 수만 갱신, 새로 코어가 된 점은 이웃 코어와 union-find로 병합
+// - 삭제: 코어를 잃은 점 주변의 코어들에서 동시에 BFS, 서로 만나면 연결 유지 -> 먼저 끝난 탐색만 새 클러스터로 분리
+// 작업량은 바뀐 점의 이웃 (분리 시 떨어져 나간 쪽) 크기에 비례, 전체 점 수와 무관
+class IncrementalDbscan
+{
+private:
+    float radius;
+    int min_points;
+
+    std::vector<Point3D> points;
+    std::vector<char> alive;
+    std::vector<char> core;
+    std::vector<int> neighbor_count; // 반경 안의 살아 있는 점 수 (자신 포함)
+
+    // union-find 노드는 코어가 될 때마다 새로 할당 (코어를 잃은 점의 노드는 다른 노드의 경로로만 남음)
+    std::vector<int> node_of;      // 점 -> 노드 (코어가 아니면 -1)
+    std::vector<int> parent;       // 노드 부모
+    std::vector<int> cluster_size; // 루트 노드의 코어 수 (병합 방향 결정용)
+
+    // 격자 셀 항목 (좌표를 같이 저장해 이웃 탐색 시 points 간접 참조를 피함)
+    struct CellEntry
+    {
+        float x, y, z;
+        int id;
+    };
+    std::unordered_map<uint64_t, std::vector<CellEntry>> cells;
+
+    uint64_t cell_key(int ix, int iy, int iz) const;
+    uint64_t cell_of(const Point3D &p) const;
+
+    // 반경 안의 살아 있는 점 (자신 포함)
+    void find_neighbors(int i, std::vector<int> &out) const;
+
+    int new_node();
+    int find_root(int node);
+    void unite(int a, int b); // 두 코어 점의 클러스터 병합
+
+    // 같은 클러스터(루트 r)의 seeds에서 동시에 BFS, 다른 탐색과 만나지 못하고 끝난 쪽을 새 클러스터로 분리
+    void resplit(int r, const std::vector<int> &seeds);
+
+public:
+    IncrementalDbscan(float radius, int min_points);
+
+    float get_radius() const { return radius; }
+    int get_min_points() const { return min_points; }
+
+    // 점 번호는 추가 순서대로 0부터 (삭제된 번호는 재사용하지 않음)
+    // 백그라운드 작업이 취소되면 중간에 멈추므로 그 뒤의 엔진은 쓰지 말고 버려야 함
+    // 반환: 첫 번째 새 점의 번호
+    int insert(const std::vector<Point3D> &pts);
+
+    void remove(const std::vector<int> &ids);
+
+    int size() const { return points.size(); }
+
+    // 점별 레이블 (-1: 노이즈 또는 삭제됨)
+    // 살아 있는 점만 모아 dbscan_clustering_kdtree를 돌린 결과와 같은 번호/경계점 배정
+    std::vector<int> labels();
+};
+
+#endif // INCREMENTAL_DBSCAN_H
@@ -0,0 +1,92 @@
+#include "job.h"
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iostream>
+
+BackgroundJob::~BackgroundJob()
+{
+    stop();
+}
+
+bool BackgroundJob::start(const std::string &name, Work work)
+{
+    if (active)
+        return false;
+
+    job_name = name;
+    control.cancel.store(false);
+    control.done.store(0);
+    control.total.store(0);
+    control.held.store(false);
+    finished.store(false);
+    apply = nullptr;
+    active = true;
+
+    current_task.store(&control);
+    worker = std::thread([this, work]()
+                         {
+                             auto start = std::chrono::high_resolution_clock::now();
+                             try
+                             {
+                                 apply = work();
+                             }
+                             catch (const std::exception &e)
+                             {
+                                 std::cerr << job_name << " 실패: " << e.what() << std::endl;
+                                 apply = nullptr;
+                             }
+                             auto end = std::chrono::high_resolution_clock::now();
+                             std::cout << job_name << " 작업 " << (control.cancel.load() ? "취소됨" : "완료") << " ("
+                                       << std::chrono::duration<float>(end - start).count() << " s)" << std::endl;
+                             finished.store(true);
+                         });
+    return true;
+}
+
+void BackgroundJob::cancel()
+{
+    if (active)
+        control.cancel.store(true);
+}
+
+float BackgroundJob::progress() const
+{
+    long long total = control.total.load(std::memory_order_relaxed);
+    if (total <= 0)
+        return -1.0f;
+    return std::min(1.0f, (float)control.done.load(std::memory_order_relaxed) / total);
+}
+
+void BackgroundJob::finish()
+{
+    worker.join();
+    current_task.store(nullptr);
+    active = false;
+}
+
+bool BackgroundJob::poll()
+{
+    if (!active || !finished.load())
+        return false;
+
+    finish();
+
+    Apply result;
+    result.swap(apply);
+    if (!result || control.cancel.load())
+        return false;
+
+    result();
+    return true;
+}
+
+void BackgroundJob::stop()
+{
+    if (!active)
+        return;
+
+    cancel();
+    finish();
+    apply = nullptr;
+}
@@ -0,0 +1,51 @@
+#ifndef JOB_H
+#define JOB_H
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+#include "parallel.h"
+
+// 렌더 스레드를 막지 않도록 작업 스레드에서 실행하는 백그라운드 작업 (한 번에 하나)
+// work는 작업 스레드에서 실행되고 주 스레드에서 적용할 함수를 반환
+// 적용 함수는 poll()에서 주 스레드로 실행 (취소되었으면 버림)
+// 진행률/취소는 current_task로 전달 (parallel_for 블록, load_obj 등의 긴 루프에서 확인)
+class BackgroundJob
+{
+public:
+    typedef std::function<void()> Apply;
+    typedef std::function<Apply()> Work;
+
+    ~BackgroundJob();
+
+    // 이미 실행 중이면 false
+    bool start(const std::string &name, Work work);
+
+    bool running() const { return active; }
+    const std::string &name() const { return job_name; }
+
+    // 취소 요청 (작업은 다음 확인 지점에서 멈춤)
+    void cancel();
+
+    // 현재 단계 진행률 0~1 (알 수 없으면 -1)
+    float progress() const;
+
+    // 주 스레드에서 매 프레임 호출: 끝난 작업을 정리하고 결과 적용, 적용했으면 true
+    bool poll();
+
+    // 취소 후 끝날 때까지 대기 (결과는 버림, 종료 전 정리용)
+    void stop();
+
+private:
+    std::thread worker;
+    TaskControl control;
+    std::atomic<bool> finished{false};
+    Apply apply;
+    std::string job_name;
+    bool active = false;
+
+    void finish();
+};
+
+#endif // JOB_H
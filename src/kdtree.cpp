@@ -1,12 +1,43 @@
 #include "kdtree.h"
+#include "parallel.h"
 #include <algorithm>
 #include <cmath>
 #include <limits>
 #include <queue>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define KDTREE_USE_SSE2
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// 패킷 마스크용 비트 연산 (MSVC에는 __builtin_ctz/__builtin_popcount가 없음)
+static inline int lowest_bit(unsigned bits)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, bits);
+    return (int)index;
+#else
+    return __builtin_ctz(bits);
+#endif
+}
+
+static inline int bit_count(unsigned bits)
+{
+#ifdef _MSC_VER
+    return (int)__popcnt(bits);
+#else
+    return __builtin_popcount(bits);
+#endif
+}
+
 // ==================== 생성자/소멸자 ====================
 
-KDTree::KDTree(const std::vector<Point3D> &pts) : root(nullptr)
+KDTree::KDTree(const std::vector<Point3D> &pts, bool lazy) : root(nullptr)
 {
     points = pts;
 
@@ -20,8 +51,16 @@ KDTree::KDTree(const std::vector<Point3D> &pts) : root(nullptr)
         indices[i] = i;
     }
 
+    if (lazy)
+    {
+        // 상위 레벨만 분할
+        lazy_indices.swap(indices);
+        root = build_top(0, lazy_indices.size());
+        return;
+    }
+
     // 트리 구축
-    root = build_tree(indices, 0);
+    root = build_tree(indices);
 }
 
 KDTree::~KDTree()
@@ -35,6 +74,7 @@ void KDTree::destroy_tree(KDNode *node)
         return;
     destroy_tree(node->left);
     destroy_tree(node->right);
+    delete node->lazy;
     delete node;
 }
 
@@ -50,13 +90,33 @@ float KDTree::distance(const Point3D &a, const Point3D &b)
 
 // ==================== 트리 구축 ====================
 
-KDNode *KDTree::build_tree(std::vector<int> &indices, int depth)
+int KDTree::split_axis(const int *indices, int count) const
+{
+    Point3D lo = points[indices[0]], hi = points[indices[0]];
+    for (int k = 1; k < count; k++)
+    {
+        const Point3D &p = points[indices[k]];
+        lo.x = std::min(lo.x, p.x);
+        lo.y = std::min(lo.y, p.y);
+        lo.z = std::min(lo.z, p.z);
+        hi.x = std::max(hi.x, p.x);
+        hi.y = std::max(hi.y, p.y);
+        hi.z = std::max(hi.z, p.z);
+    }
+
+    float ex = hi.x - lo.x, ey = hi.y - lo.y, ez = hi.z - lo.z;
+    if (ex >= ey && ex >= ez)
+        return 0;
+    return ey >= ez ? 1 : 2;
+}
+
+KDNode *KDTree::build_tree(std::vector<int> &indices)
 {
     if (indices.empty())
         return nullptr;
 
-    // 축 선택 (x=0, y=1, z=2 순환)
-    int axis = depth % 3;
+    // 축 선택 (범위가 가장 넓은 축)
+    int axis = split_axis(indices.data(), indices.size());
 
     // 해당 축으로 정렬
     std::sort(indices.begin(), indices.end(),
@@ -71,36 +131,111 @@ KDNode *KDTree::build_tree(std::vector<int> &indices, int depth)
 
     // 중앙값 선택
     size_t median = indices.size() / 2;
-    KDNode *node = new KDNode(indices[median]);
+    KDNode *node = new KDNode(indices[median], axis);
 
     // 좌우 서브트리 재귀 구축
     std::vector<int> left_indices(indices.begin(), indices.begin() + median);
     std::vector<int> right_indices(indices.begin() + median + 1, indices.end());
 
-    node->left = build_tree(left_indices, depth + 1);
-    node->right = build_tree(right_indices, depth + 1);
+    node->left = build_tree(left_indices);
+    node->right = build_tree(right_indices);
+
+    return node;
+}
+
+// ==================== 지연 구축 ====================
+
+KDNode *KDTree::build_top(int begin, int end)
+{
+    if (begin >= end)
+        return nullptr;
+
+    int axis = split_axis(lazy_indices.data() + begin, end - begin);
+
+    // 중앙값만 제자리에 (build_tree와 같은 위치의 중앙값)
+    int median = begin + (end - begin) / 2;
+    std::nth_element(lazy_indices.begin() + begin, lazy_indices.begin() + median,
+                     lazy_indices.begin() + end,
+                     [this, axis](int a, int b)
+                     {
+                         if (axis == 0)
+                             return points[a].x < points[b].x;
+                         if (axis == 1)
+                             return points[a].y < points[b].y;
+                         return points[a].z < points[b].z;
+                     });
+
+    KDNode *node = new KDNode(lazy_indices[median], axis);
+
+    if (end - begin > KDTREE_LAZY_SUBTREE_SIZE)
+    {
+        node->left = build_top(begin, median);
+        node->right = build_top(median + 1, end);
+    }
+    else
+    {
+        // 작은 서브트리는 처음 탐색될 때 구축
+        node->lazy = new LazyBuild(begin, median, end);
+        lazy_nodes.push_back(node);
+    }
 
     return node;
 }
 
+void KDTree::expand(KDNode *node)
+{
+    LazyBuild *lazy = node->lazy;
+    if (!lazy)
+        return;
+
+    // call_once 완료 이후 다른 스레드도 left/right를 안전하게 읽을 수 있음
+    std::call_once(lazy->once, [this, node, lazy]()
+                   {
+                       std::vector<int> left_indices(lazy_indices.begin() + lazy->begin,
+                                                     lazy_indices.begin() + lazy->median);
+                       std::vector<int> right_indices(lazy_indices.begin() + lazy->median + 1,
+                                                      lazy_indices.begin() + lazy->end);
+
+                       node->left = build_tree(left_indices);
+                       node->right = build_tree(right_indices);
+                   });
+}
+
+void KDTree::build_all()
+{
+    parallel_for(0, (int)lazy_nodes.size(), 1, [this](int begin, int end, int)
+                 {
+                     for (int i = begin; i < end; i++)
+                     {
+                         expand(lazy_nodes[i]);
+                     }
+                 });
+}
+
 // ==================== 반경 탐색 ====================
 
 void KDTree::search_radius(KDNode *node, const Point3D &target, float radius,
-                           std::vector<int> &neighbors, int depth)
+                           std::vector<int> &neighbors, const KDTreeFilter *filter)
 {
     if (!node)
         return;
 
+    // 활성 점이 하나도 없는 서브트리는 생략
+    if (filter && filter->subtree_active[node->index] == 0)
+        return;
+
+    expand(node);
+
     // 현재 노드와의 거리
     float dist = distance(points[node->index], target);
 
-    if (dist <= radius)
+    if (dist <= radius && (!filter || filter->active[node->index]))
     {
         neighbors.push_back(node->index);
     }
 
     // 축 선택
-    int axis = depth % 3;
+    int axis = node->axis;
     float target_val, node_val;
 
     if (axis == 0)
@@ -123,18 +258,504 @@ void KDTree::search_radius(KDNode *node, const Point3D &target, float radius,
     KDNode *near = (target_val < node_val) ? node->left : node->right;
     KDNode *far = (target_val < node_val) ? node->right : node->left;
 
-    search_radius(near, target, radius, neighbors, depth + 1);
+    search_radius(near, target, radius, neighbors, filter);
 
     // 반대편도 확인 필요한지
     float axis_dist = std::abs(target_val - node_val);
     if (axis_dist <= radius)
     {
-        search_radius(far, target, radius, neighbors, depth + 1);
+        search_radius(far, target, radius, neighbors, filter);
     }
 }
-std::vector<int> KDTree::find_radius(const Point3D &target, float radius)
+std::vector<int> KDTree::find_radius(const Point3D &target, float radius,
+                                     const KDTreeFilter *filter)
 {
     std::vector<int> neighbors;
-    search_radius(root, target, radius, neighbors, 0);
+    search_radius(root, target, radius, neighbors, filter);
     return neighbors;
-}
\ No newline at end of file
+}
+
+// ==================== 공간 순서 ====================
+
+void KDTree::collect_order(KDNode *node, std::vector<int> &order)
+{
+    if (!node)
+        return;
+
+    expand(node);
+
+    collect_order(node->left, order);
+    order.push_back(node->index);
+    collect_order(node->right, order);
+}
+
+std::vector<int> KDTree::spatial_order()
+{
+    std::vector<int> order;
+    order.reserve(points.size());
+    collect_order(root, order);
+    return order;
+}
+
+// ==================== 활성 점 필터 ====================
+
+int KDTree::count_active(KDNode *node, KDTreeFilter &filter)
+{
+    if (!node)
+        return 0;
+
+    expand(node);
+
+    int count = filter.active[node->index] ? 1 : 0;
+    count += count_active(node->left, filter);
+    count += count_active(node->right, filter);
+
+    filter.subtree_active[node->index] = count;
+    return count;
+}
+
+KDTreeFilter KDTree::make_filter(const std::vector<bool> &active)
+{
+    KDTreeFilter filter;
+    filter.active = active;
+    filter.active.resize(points.size(), false);
+    filter.subtree_active.assign(points.size(), 0);
+
+    // 지연 모드면 남은 서브트리부터 구축 (카운트는 트리 전체를 순회)
+    build_all();
+    count_active(root, filter);
+
+    return filter;
+}
+
+// ==================== 다중 반경 탐색 ====================
+
+void KDTree::search_radius_multi(KDNode *node, const Point3D &target, const float *radii,
+                                 int radius_count, int *histogram,
+                                 const KDTreeFilter *filter)
+{
+    if (!node)
+        return;
+
+    if (filter && filter->subtree_active[node->index] == 0)
+        return;
+
+    expand(node);
+
+    float max_radius = radii[radius_count - 1];
+
+    // 현재 노드와의 거리 -> dist <= radii[k]를 만족하는 가장 작은 k 구간에 누적
+    float dist = distance(points[node->index], target);
+
+    if (dist <= max_radius && (!filter || filter->active[node->index]))
+    {
+        int k = std::lower_bound(radii, radii + radius_count, dist) - radii;
+        histogram[k]++;
+    }
+
+    // 축 선택
+    int axis = node->axis;
+    float target_val, node_val;
+
+    if (axis == 0)
+    {
+        target_val = target.x;
+        node_val = points[node->index].x;
+    }
+    else if (axis == 1)
+    {
+        target_val = target.y;
+        node_val = points[node->index].y;
+    }
+    else
+    {
+        target_val = target.z;
+        node_val = points[node->index].z;
+    }
+
+    KDNode *near = (target_val < node_val) ? node->left : node->right;
+    KDNode *far = (target_val < node_val) ? node->right : node->left;
+
+    search_radius_multi(near, target, radii, radius_count, histogram, filter);
+
+    if (std::abs(target_val - node_val) <= max_radius)
+    {
+        search_radius_multi(far, target, radii, radius_count, histogram, filter);
+    }
+}
+
+void KDTree::count_radius_multi(const Point3D &target, const std::vector<float> &radii,
+                                int *counts, const KDTreeFilter *filter)
+{
+    int radius_count = radii.size();
+    if (radius_count == 0)
+        return;
+
+    std::fill(counts, counts + radius_count, 0);
+    search_radius_multi(root, target, radii.data(), radius_count, counts, filter);
+
+    // 구간별 개수 -> 누적 개수
+    for (int k = 1; k < radius_count; k++)
+    {
+        counts[k] += counts[k - 1];
+    }
+}
+
+// ==================== k-최근접 탐색 ====================
+
+void KDTree::search_knn(KDNode *node, const Point3D &target, int k,
+                        std::vector<std::pair<float, int>> &heap,
+                        const KDTreeFilter *filter)
+{
+    if (!node)
+        return;
+
+    if (filter && filter->subtree_active[node->index] == 0)
+        return;
+
+    expand(node);
+
+    // 제곱 거리로 비교하고 결과에서만 sqrt (distance()와 같은 식이라 k번째 거리도 같음)
+    const Point3D &p = points[node->index];
+    float dx = p.x - target.x;
+    float dy = p.y - target.y;
+    float dz = p.z - target.z;
+    float dist = dx * dx + dy * dy + dz * dz;
+
+    if (!filter || filter->active[node->index])
+    {
+        if ((int)heap.size() < k)
+        {
+            heap.push_back({dist, node->index});
+            std::push_heap(heap.begin(), heap.end());
+        }
+        else if (dist < heap.front().first)
+        {
+            std::pop_heap(heap.begin(), heap.end());
+            heap.back() = {dist, node->index};
+            std::push_heap(heap.begin(), heap.end());
+        }
+    }
+
+    int axis = node->axis;
+    float target_val, node_val;
+
+    if (axis == 0)
+    {
+        target_val = target.x;
+        node_val = p.x;
+    }
+    else if (axis == 1)
+    {
+        target_val = target.y;
+        node_val = p.y;
+    }
+    else
+    {
+        target_val = target.z;
+        node_val = p.z;
+    }
+
+    KDNode *near = (target_val < node_val) ? node->left : node->right;
+    KDNode *far = (target_val < node_val) ? node->right : node->left;
+
+    search_knn(near, target, k, heap, filter);
+
+    // 아직 k개가 안 모였거나 분할면이 현재 k번째 거리보다 가까우면 반대편 확인
+    float axis_dist = target_val - node_val;
+    if ((int)heap.size() < k || axis_dist * axis_dist < heap.front().first)
+    {
+        search_knn(far, target, k, heap, filter);
+    }
+}
+
+void KDTree::find_knn(const Point3D &target, int k, std::vector<int> &indices,
+                      std::vector<float> &distances, const KDTreeFilter *filter)
+{
+    indices.clear();
+    distances.clear();
+    if (k <= 0)
+        return;
+
+    std::vector<std::pair<float, int>> heap;
+    heap.reserve(k);
+    search_knn(root, target, k, heap, filter);
+
+    std::sort_heap(heap.begin(), heap.end());
+    for (const auto &h : heap)
+    {
+        distances.push_back(std::sqrt(h.first));
+        indices.push_back(h.second);
+    }
+}
+
+float KDTree::kth_distance(const Point3D &target, int k, const KDTreeFilter *filter)
+{
+    if (k <= 0)
+        return -1.0f;
+
+    std::vector<std::pair<float, int>> heap;
+    heap.reserve(k);
+    search_knn(root, target, k, heap, filter);
+
+    if ((int)heap.size() < k)
+        return -1.0f;
+    return std::sqrt(heap.front().first);
+}
+
+// ==================== 패킷 탐색 ====================
+
+// 노드 점 p와 패킷의 각 쿼리 거리 비교 (4개씩 SIMD), 반경 안이면 해당 비트 set
+static unsigned packet_hits(const float *qx, const float *qy, const float *qz,
+                            int count, const Point3D &p, float radius)
+{
+    unsigned hits = 0;
+#ifdef KDTREE_USE_SSE2
+    __m128 px = _mm_set1_ps(p.x);
+    __m128 py = _mm_set1_ps(p.y);
+    __m128 pz = _mm_set1_ps(p.z);
+    __m128 r = _mm_set1_ps(radius);
+    for (int q = 0; q < count; q += 4)
+    {
+        __m128 dx = _mm_sub_ps(_mm_load_ps(qx + q), px);
+        __m128 dy = _mm_sub_ps(_mm_load_ps(qy + q), py);
+        __m128 dz = _mm_sub_ps(_mm_load_ps(qz + q), pz);
+        __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)),
+                               _mm_mul_ps(dz, dz));
+        // distance()와 같은 비교 (sqrt 후 반경 비교)
+        __m128 in = _mm_cmple_ps(_mm_sqrt_ps(d2), r);
+        hits |= (unsigned)_mm_movemask_ps(in) << q;
+    }
+#else
+    for (int q = 0; q < count; q++)
+    {
+        float dx = qx[q] - p.x;
+        float dy = qy[q] - p.y;
+        float dz = qz[q] - p.z;
+        if (std::sqrt(dx * dx + dy * dy + dz * dz) <= radius)
+            hits |= 1u << q;
+    }
+#endif
+    return hits;
+}
+
+void KDTree::search_packet(KDNode *node, const QueryPacket &packet, unsigned mask,
+                           std::vector<int> *neighbors, int *counts,
+                           const KDTreeFilter *filter)
+{
+    if (!node || !mask)
+        return;
+
+    if (filter && filter->subtree_active[node->index] == 0)
+        return;
+
+    expand(node);
+
+    const Point3D &p = points[node->index];
+
+    // 현재 노드와의 거리 (패킷 전체)
+    unsigned hits = 0;
+    if (!filter || filter->active[node->index])
+    {
+        hits = packet_hits(packet.x, packet.y, packet.z, packet.count, p, packet.radius) & mask;
+    }
+    for (int q = 0; hits; q++, hits >>= 1)
+    {
+        if (!(hits & 1))
+            continue;
+        if (neighbors)
+            neighbors[q].push_back(node->index);
+        else
+            counts[q]++;
+    }
+
+    // 축 선택
+    int axis = node->axis;
+    const float *target_vals;
+    float node_val;
+
+    if (axis == 0)
+    {
+        target_vals = packet.x;
+        node_val = p.x;
+    }
+    else if (axis == 1)
+    {
+        target_vals = packet.y;
+        node_val = p.y;
+    }
+    else
+    {
+        target_vals = packet.z;
+        node_val = p.z;
+    }
+
+    // 쿼리별로 좌/우 방문 여부 결정 (search_radius와 같은 조건)
+    // 왼쪽: target < node 이거나 축 거리 <= radius
+    // 오른쪽: target >= node 이거나 축 거리 <= radius
+    unsigned left_mask = 0, right_mask = 0;
+#ifdef KDTREE_USE_SSE2
+    __m128 v = _mm_set1_ps(node_val);
+    __m128 r = _mm_set1_ps(packet.radius);
+    __m128 sign = _mm_set1_ps(-0.0f);
+    for (int q = 0; q < packet.count; q += 4)
+    {
+        __m128 t = _mm_load_ps(target_vals + q);
+        __m128 axis_dist = _mm_andnot_ps(sign, _mm_sub_ps(t, v));
+        __m128 in_range = _mm_cmple_ps(axis_dist, r);
+        left_mask |= (unsigned)_mm_movemask_ps(_mm_or_ps(_mm_cmplt_ps(t, v), in_range)) << q;
+        right_mask |= (unsigned)_mm_movemask_ps(_mm_or_ps(_mm_cmpge_ps(t, v), in_range)) << q;
+    }
+#else
+    for (int q = 0; q < packet.count; q++)
+    {
+        float t = target_vals[q];
+        bool in_range = std::abs(t - node_val) <= packet.radius;
+        if (t < node_val || in_range)
+            left_mask |= 1u << q;
+        if (t >= node_val || in_range)
+            right_mask |= 1u << q;
+    }
+#endif
+
+    // 모든 쿼리가 범위 밖인 쪽은 건너뜀
+    search_packet(node->left, packet, mask & left_mask, neighbors, counts, filter);
+    search_packet(node->right, packet, mask & right_mask, neighbors, counts, filter);
+}
+
+void KDTree::search_count_packet(KDNode *node, const QueryPacket &packet, unsigned mask, unsigned &live,
+                                 int *counts, int limit, const KDTreeFilter *filter)
+{
+    mask &= live;
+    if (!node || !mask)
+        return;
+
+    if (filter && filter->subtree_active[node->index] == 0)
+        return;
+
+    expand(node);
+
+    const Point3D &p = points[node->index];
+
+    unsigned hits = 0;
+    if (!filter || filter->active[node->index])
+    {
+        hits = packet_hits(packet.x, packet.y, packet.z, packet.count, p, packet.radius) & mask;
+    }
+    for (; hits; hits &= hits - 1)
+    {
+        int q = lowest_bit(hits);
+        if (++counts[q] >= limit)
+            live &= ~(1u << q);
+    }
+
+    int axis = node->axis;
+    const float *target_vals;
+    float node_val;
+
+    if (axis == 0)
+    {
+        target_vals = packet.x;
+        node_val = p.x;
+    }
+    else if (axis == 1)
+    {
+        target_vals = packet.y;
+        node_val = p.y;
+    }
+    else
+    {
+        target_vals = packet.z;
+        node_val = p.z;
+    }
+
+    // search_packet과 같은 좌/우 조건, 쿼리 다수가 있는 쪽을 먼저 방문해 일찍 limit에 도달
+    unsigned left_mask = 0, right_mask = 0, left_side = 0;
+    for (int q = 0; q < packet.count; q++)
+    {
+        float t = target_vals[q];
+        bool in_range = std::abs(t - node_val) <= packet.radius;
+        if (t < node_val)
+            left_side |= 1u << q;
+        if (t < node_val || in_range)
+            left_mask |= 1u << q;
+        if (t >= node_val || in_range)
+            right_mask |= 1u << q;
+    }
+
+    if (bit_count(left_side & mask) * 2 >= bit_count(mask))
+    {
+        search_count_packet(node->left, packet, mask & left_mask, live, counts, limit, filter);
+        search_count_packet(node->right, packet, mask & right_mask, live, counts, limit, filter);
+    }
+    else
+    {
+        search_count_packet(node->right, packet, mask & right_mask, live, counts, limit, filter);
+        search_count_packet(node->left, packet, mask & left_mask, live, counts, limit, filter);
+    }
+}
+
+// 패킷 구성 (남는 칸은 0으로 채우고 mask로 제외)
+static unsigned fill_packet(float *x, float *y, float *z, const Point3D *targets, int count)
+{
+    for (int q = 0; q < KDTREE_PACKET_SIZE; q++)
+    {
+        bool used = q < count;
+        x[q] = used ? targets[q].x : 0.0f;
+        y[q] = used ? targets[q].y : 0.0f;
+        z[q] = used ? targets[q].z : 0.0f;
+    }
+    return count >= 32 ? ~0u : (1u << count) - 1;
+}
+
+void KDTree::find_radius_packet(const Point3D *targets, int count, float radius,
+                                std::vector<int> *neighbors, const KDTreeFilter *filter)
+{
+    // 패킷 크기를 넘으면 나눠서 처리
+    for (int start = 0; start < count; start += KDTREE_PACKET_SIZE)
+    {
+        int n = std::min(KDTREE_PACKET_SIZE, count - start);
+
+        QueryPacket packet;
+        unsigned mask = fill_packet(packet.x, packet.y, packet.z, targets + start, n);
+        packet.count = (n + 3) & ~3; // SIMD 4개 단위
+        packet.radius = radius;
+
+        search_packet(root, packet, mask, neighbors + start, nullptr, filter);
+    }
+}
+
+void KDTree::count_radius_packet(const Point3D *targets, int count, float radius,
+                                 int *counts, const KDTreeFilter *filter)
+{
+    for (int start = 0; start < count; start += KDTREE_PACKET_SIZE)
+    {
+        int n = std::min(KDTREE_PACKET_SIZE, count - start);
+
+        QueryPacket packet;
+        unsigned mask = fill_packet(packet.x, packet.y, packet.z, targets + start, n);
+        packet.count = (n + 3) & ~3;
+        packet.radius = radius;
+
+        std::fill(counts + start, counts + start + n, 0);
+        search_packet(root, packet, mask, nullptr, counts + start, filter);
+    }
+}
+
+void KDTree::count_radius_packet_limit(const Point3D *targets, int count, float radius, int limit,
+                                       int *counts, const KDTreeFilter *filter)
+{
+    for (int start = 0; start < count; start += KDTREE_PACKET_SIZE)
+    {
+        int n = std::min(KDTREE_PACKET_SIZE, count - start);
+
+        QueryPacket packet;
+        unsigned mask = fill_packet(packet.x, packet.y, packet.z, targets + start, n);
+        packet.count = (n + 3) & ~3;
+        packet.radius = radius;
+
+        std::fill(counts + start, counts + start + n, 0);
+        unsigned live = limit > 0 ? mask : 0;
+        search_count_packet(root, packet, mask, live, counts + start, limit, filter);
+    }
+}
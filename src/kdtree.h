@@ -1,31 +1,109 @@
 #ifndef KDTREE_H
 #define KDTREE_H
 
+#include <mutex>
+#include <utility>
 #include <vector>
 #include "point3d.h"
 
+// 지연 구축 대기 중인 좌우 서브트리 (lazy_indices의 [begin, median), [median+1, end) 구간)
+struct LazyBuild
+{
+    std::once_flag once;
+    int begin, median, end;
+
+    LazyBuild(int b, int m, int e) : begin(b), median(m), end(e) {}
+};
+
 // KD-Tree 노드
 struct KDNode
 {
     int index; // 원본 정점 인덱스
+    int axis;  // 분할 축 (x=0, y=1, z=2)
     KDNode *left;
     KDNode *right;
+    LazyBuild *lazy; // 자식이 아직 구축되지 않았으면 non-null
+
+    KDNode(int idx, int ax) : index(idx), axis(ax), left(nullptr), right(nullptr), lazy(nullptr) {}
+};
+
+// 지연 모드에서 이 크기 이하의 서브트리는 처음 탐색될 때 구축
+const int KDTREE_LAZY_SUBTREE_SIZE = 32768;
 
-    KDNode(int idx) : index(idx), left(nullptr), right(nullptr) {}
+// 활성 점 필터: 트리를 다시 만들지 않고 제거된 점을 건너뛰는 탐색용
+// KDTree::make_filter로 생성 (서브트리 활성 점 수가 0이면 서브트리 전체 생략)
+struct KDTreeFilter
+{
+    std::vector<bool> active;        // 점별 활성 여부
+    std::vector<int> subtree_active; // 노드(= 노드의 점 인덱스)별 서브트리 활성 점 수
 };
 
+// 패킷 탐색 한 번에 묶을 수 있는 최대 쿼리 수
+const int KDTREE_PACKET_SIZE = 16;
+
 // KD-Tree 클래스
 class KDTree
 {
 private:
+    // 패킷 쿼리 (SoA, SIMD 정렬)
+    struct QueryPacket
+    {
+        alignas(16) float x[KDTREE_PACKET_SIZE];
+        alignas(16) float y[KDTREE_PACKET_SIZE];
+        alignas(16) float z[KDTREE_PACKET_SIZE];
+        int count;
+        float radius;
+    };
+
     KDNode *root;
     std::vector<Point3D> points;
 
+    // 지연 모드: 상위 레벨 분할 결과와 구축 대기 노드
+    std::vector<int> lazy_indices;
+    std::vector<KDNode *> lazy_nodes;
+
+    // 분할 축: 점들의 범위가 가장 넓은 축
+    // (축을 순환하면 벽/바닥처럼 얇은 면에서 두께 방향 분할이 가지치기를 못 해 탐색 노드가 몇 배로 늘어남)
+    int split_axis(const int *indices, int count) const;
+
     // 재귀적으로 트리 구축
-    KDNode *build_tree(std::vector<int> &indices, int depth);
+    KDNode *build_tree(std::vector<int> &indices);
+
+    // 지연 모드 상위 레벨 분할 (nth_element, 작은 서브트리는 구축 보류)
+    KDNode *build_top(int begin, int end);
+
+    // 보류된 자식 서브트리 구축 (스레드 안전, 한 번만 실행)
+    void expand(KDNode *node);
 
+    // filter가 있으면 비활성 점은 결과에서 빠지고 활성 점이 없는 서브트리는 생략
     void search_radius(KDNode *node, const Point3D &target, float radius,
-                       std::vector<int> &neighbors, int depth);
+                       std::vector<int> &neighbors, const KDTreeFilter *filter);
+
+    // 패킷 탐색: mask 비트가 켜진 쿼리만 이 노드를 방문
+    void search_packet(KDNode *node, const QueryPacket &packet, unsigned mask,
+                       std::vector<int> *neighbors, int *counts,
+                       const KDTreeFilter *filter);
+
+    // 조기 종료 패킷 개수 탐색: live = 아직 limit개에 못 미친 쿼리 (모든 방문이 공유)
+    // 쿼리가 limit개에 도달하면 live에서 빠져 이후 노드는 방문하지 않음
+    void search_count_packet(KDNode *node, const QueryPacket &packet, unsigned mask, unsigned &live,
+                             int *counts, int limit, const KDTreeFilter *filter);
+
+    // 다중 반경 탐색: 가장 큰 반경으로 가지치기, 거리가 속한 반경 구간에 누적
+    void search_radius_multi(KDNode *node, const Point3D &target, const float *radii,
+                             int radius_count, int *histogram,
+                             const KDTreeFilter *filter);
+
+    // k-최근접 탐색: heap = 지금까지 찾은 가장 가까운 k개 (제곱 거리, 인덱스)의 최대 힙
+    // k개가 모이면 가장 먼 거리로 가지치기
+    void search_knn(KDNode *node, const Point3D &target, int k,
+                    std::vector<std::pair<float, int>> &heap,
+                    const KDTreeFilter *filter);
+
+    // 서브트리 활성 점 수 계산
+    int count_active(KDNode *node, KDTreeFilter &filter);
+
+    void collect_order(KDNode *node, std::vector<int> &order);
 
     // 거리 계산
     float distance(const Point3D &a, const Point3D &b);
@@ -34,11 +112,52 @@ private:
     void destroy_tree(KDNode *node);
 
 public:
-    KDTree(const std::vector<Point3D> &pts);
+    // lazy = true: 상위 레벨만 분할하고 하위 서브트리는 처음 탐색될 때 구축
+    KDTree(const std::vector<Point3D> &pts, bool lazy = false);
     ~KDTree();
 
-    std::vector<int> find_radius(const Point3D &target, float radius);
+    // 보류된 서브트리를 모두 병렬로 구축 (전체 탐색 전에 호출하면 빠름)
+    void build_all();
+
+    // 트리 중위 순회 순서의 점 인덱스 (공간적으로 가까운 점끼리 인접)
+    // 패킷 탐색 묶음이나 병렬 블록 분할에 사용
+    std::vector<int> spatial_order();
+
+    // 활성 점 비트셋으로 필터 생성 (active.size() == 점 개수)
+    KDTreeFilter make_filter(const std::vector<bool> &active);
+
+    // 아래 탐색 함수들은 filter를 주면 활성 점만 결과에 포함
+    std::vector<int> find_radius(const Point3D &target, float radius,
+                                 const KDTreeFilter *filter = nullptr);
+
+    // 공간적으로 인접한 쿼리들을 KDTREE_PACKET_SIZE개씩 묶어 한 번의 순회로 탐색
+    // neighbors[q]에 q번째 쿼리의 이웃이 추가됨 (순서는 find_radius와 다를 수 있음)
+    void find_radius_packet(const Point3D *targets, int count, float radius,
+                            std::vector<int> *neighbors,
+                            const KDTreeFilter *filter = nullptr);
+
+    // 패킷 이웃 개수만 계산 (counts[q] = q번째 쿼리의 이웃 수)
+    void count_radius_packet(const Point3D *targets, int count, float radius,
+                             int *counts, const KDTreeFilter *filter = nullptr);
+
+    // count_radius_packet과 같지만 limit개를 찾은 쿼리는 더 탐색하지 않음
+    // counts[q] = min(q번째 쿼리의 이웃 수, limit) -> "limit개 이상인가"만 필요할 때 사용
+    void count_radius_packet_limit(const Point3D *targets, int count, float radius, int limit,
+                                   int *counts, const KDTreeFilter *filter = nullptr);
+
+    // 오름차순 반경 목록 각각의 이웃 수를 한 번의 순회로 계산
+    // counts[k] = find_radius(target, radii[k]).size()
+    void count_radius_multi(const Point3D &target, const std::vector<float> &radii,
+                            int *counts, const KDTreeFilter *filter = nullptr);
+
+    // 가장 가까운 k개 점 (target이 트리의 점이면 자신 포함), 거리 오름차순
+    // 점이 k개보다 적으면 있는 만큼만 채움
+    void find_knn(const Point3D &target, int k, std::vector<int> &indices,
+                  std::vector<float> &distances, const KDTreeFilter *filter = nullptr);
 
+    // k번째로 가까운 점까지의 거리 (자신 포함, 점이 k개보다 적으면 -1)
+    // find_radius(target, r).size() >= k 와 r >= kth_distance(target, k)는 같음
+    float kth_distance(const Point3D &target, int k, const KDTreeFilter *filter = nullptr);
 };
 
 #endif // KDTREE_H
\ No newline at end of file
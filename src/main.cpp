@@ -1,10 +1,9 @@
 #include <iostream>
 #include <vector>
-#include <map>
 #include <cmath>
 #include <chrono>
+#include <memory>
 #include <nfd.h>
-#include <set>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -20,6 +19,15 @@
 #include "kdtree.h"
 #include "clustering.h"
 #include "floor.h"
+#include "sampled_dbscan.h"
+#include "tiled_dbscan.h"
+#include "incremental_dbscan.h"
+#include "multiprocess_dbscan.h"
+#include "benchmark.h"
+#include "outlier.h"
+#include "subsample.h"
+#include "normals.h"
+#include "job.h"
 
 // ========== 전역 변수 ==========
 int window_width = 1280;
@@ -27,6 +35,7 @@ int window_height = 720;
 bool floor_removed = false;
 std::vector<Point3D> dbscan_result_points;
 std::vector<int> filtered_indices;
+std::vector<bool> dbscan_mask; // 현재 결과의 점 (DBSCAN/필터/바닥 제거 후, 원본 인덱스 기준, 트리 필터용)
 float floor_removal_time = 0.0f;
 
 // 카메라 변수
@@ -50,14 +59,97 @@ std::string current_obj_name = "";
 // 파라미터
 float epsilon = 0.05f;
 int min_points = 10;
+int dbscan_method = 1; // 0: KD-Tree 병렬, 1: 격자, 2: 이웃 그래프 캐시 (레이블은 같음), 3: 최대 클러스터만, 4: 샘플링 근사, 5: 증분, 6: 다중 프로세스, 7: 밀도 적응
+
+// 이웃 그래프 캐시 (현재 점군 + epsilon 기준, MinPts 변경과 더 작은 epsilon에 재사용)
+NeighborGraph neighbor_graph;
+int graph_budget_mb = 512; // 이보다 크면 사용 후 바로 해제
+
+// 샘플링 근사 DBSCAN
+float sample_voxel_size = 0.05f;
+SampledDbscanQuality sample_quality;
+bool sample_quality_ready = false;
+
+// 파일 타일 DBSCAN (메모리에 올리지 않고 파일에서 바로 처리)
+int tiled_budget_mb = 1024;
+TiledDbscanStats tiled_stats;
+bool tiled_done = false;
+
+// 밀도 적응 DBSCAN (점별 반경 = min(Scale x 국소 거리, epsilon), 국소 거리는 MinPts가 바뀔 때만 다시 계산)
+float adaptive_scale = 1.5f;
+std::vector<float> local_scales;
+int local_scales_k = -1;
+
+// DBSCAN 입력 (0: 원본 점, 1: 복셀 점, 2: FPS/Poisson 샘플, 3: 현재 결과)
+// 원본 점이 아니면 KD-Tree/Grid/Largest/Sampled/Processes DBSCAN을 그 점에서 실행하고 원본 점으로 되돌림
+// 현재 결과는 이상점 필터 등으로 먼저 줄인 점 (결과가 없으면 원본 점)
+int dbscan_input = 0;
+
+// 복셀 다운샘플링
+float downsample_voxel_size = 0.02f;
+bool downsample_nearest = false; // false: 복셀 중심, true: 중심에 가장 가까운 원본 점
+PointSubsample voxel_subsample;  // 캐시 (크기/방식이 같으면 재사용)
+KDTree *voxel_tree = nullptr;
+float voxel_subsample_size = -1.0f;
+bool voxel_subsample_nearest = false;
+
+// 균일 샘플 (가장 먼 점 / 포아송 디스크, 원본 인덱스 목록)
+int fps_count = 10000;
+float poisson_spacing = 0.02f;
+PointSubsample uniform_sample;
+KDTree *uniform_sample_tree = nullptr;
+
+// 통계적 이상점 제거 (현재 결과의 점에 적용, 결과는 DBSCAN과 같은 마스크로 반영)
+int sor_k = 16;
+float sor_std_ratio = 1.0f;
+OutlierFilterStats sor_stats;
+
+// 반경 이상점 제거 (Radius 이내 이웃이 Min Neighbors개 미만인 점 제거)
+float ror_radius = 0.02f;
+int ror_min_neighbors = 8;
+OutlierFilterStats ror_stats;
+
+// 국소 이상치 계수 (LOF, k-최근접 그래프는 대상 점이 같으면 LOF K 이하의 k에 재사용)
+int lof_k = 10;
+float lof_threshold = 1.5f;
+KnnGraph lof_graph;
+std::vector<float> lof_scores; // 원본 인덱스별 점수 (대상이 아닌 점은 0)
+std::vector<bool> lof_active;  // 점수를 계산한 점
+int lof_above = 0;             // 점수가 기준 이상인 점 수
+bool show_lof = false;
+
+// 법선/곡률 추정 (k-최근접 PCA, 메시에 법선이 없으면 저장할 때 vn으로 기록)
+int normal_k = 16;
+PointNormals point_normals;
+float mean_curvature = 0.0f;
+int normal_count = 0; // 법선을 추정한 점 수
+float max_curvature = 0.1f;    // 곡률 필터 기준 (이보다 큰 점 제거)
+int saved_missing_normals = 0; // 마지막 저장에서 추정 법선이 없어 vn 0 0 0으로 쓴 점 수
+
+// 저장 파일 이름 꼬리 (적용한 단계 순서, 예: _dbscan_ror -> 바닥 제거 시 _floor 추가)
+std::string result_suffix;
+
+// 증분 DBSCAN (Append OBJ로 추가한 점만 반영, epsilon/MinPts가 바뀌면 처음부터 다시 구축)
+IncrementalDbscan *incremental = nullptr;
+
+// 다중 프로세스 DBSCAN (공유 메모리 + 작업 프로세스)
+int process_workers = 4;
+MultiprocessDbscanStats process_stats;
+
+// OPTICS (한 번 계산 후 Max Epsilon 이하 epsilon은 선형 스캔으로 재클러스터링)
+OpticsResult optics;
+bool optics_ready = false;
+float optics_max_epsilon = 0.1f;
 float point_size = 2.0f;
 
+// 백그라운드 작업 (Load/Append OBJ, DBSCAN, 필터, Remove Floor, Save Result 등 오래 걸리는 작업은 작업 스레드에서 실행, 결과는 주 스레드에서 적용)
+BackgroundJob job;
+
 // 통계
 int total_points = 0;
 int removed_points = 0;
 bool dbscan_applied = false;
 float last_execution_time = 0.0f;
-std::vector<int> current_labels;
 
 // OpenGL 버퍼
 GLuint vao = 0;
@@ -71,26 +163,48 @@ std::vector<Point3D> floor_vis_points;
 bool show_floor_vis = false;
 float floor_ratio = 0.15f;
 
+// LOF 색 표시용 (점 + 점수)
+GLuint lof_vao = 0;
+GLuint lof_vbo = 0;
+int lof_vis_count = 0;
+
 //바닥 자르기
 float search_radius = 0.1f;
 float mid_start = 0.10f;
 float mid_end = 0.40f;
 int min_points_above = 30;
 
+// 반경별 곡선 (파라미터 튜닝용, 트리 한 번 순회로 모든 반경 계산)
+const int CURVE_SAMPLES = 16;
+std::vector<float> epsilon_curve_radii;
+std::vector<float> epsilon_curve; // epsilon 후보별 코어 점 비율
+std::vector<float> floor_curve_radii;
+std::vector<float> floor_curve; // search_radius 후보별 바닥 점 제거 비율
+
+// k-거리 곡선 (epsilon 추천, k = MinPts)
+const int K_DISTANCE_PLOT_SAMPLES = 256;
+float k_distance_sample_percent = 1.0f;
+KDistanceCurve k_distance;
+std::vector<float> k_distance_plot; // 그래프용으로 줄인 곡선
+
 // ========== 셰이더 소스 ==========
 const char *vertex_shader_source = R"(
 #version 330 core
 layout (location = 0) in vec3 aPos;
+layout (location = 1) in float aScore; // LOF 점수 (LOF 표시 버퍼에만 있음)
 
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 uniform float pointSize;
 
+out float vScore;
+
 void main()
 {
     gl_Position = projection * view * model * vec4(aPos, 1.0);
     gl_PointSize = pointSize;
+    vScore = aScore;
 }
 )";
 
@@ -98,10 +212,22 @@ const char *fragment_shader_source = R"(
 #version 330 core
 out vec4 FragColor;
 
+in float vScore;
+
 uniform vec3 color;  // <- 추가
+uniform bool useScore;        // LOF 색 표시
+uniform float scoreThreshold; // 이 점수 이상은 빨간색
 
 void main()
 {
+    if (useScore)
+    {
+        // 1(주변과 같은 밀도) 파랑 -> 기준 바로 아래 노랑, 기준 이상 빨강
+        float t = clamp((vScore - 1.0) / max(scoreThreshold - 1.0, 0.001), 0.0, 1.0);
+        vec3 score_color = vScore >= scoreThreshold ? vec3(1.0, 0.0, 0.0) : mix(vec3(0.2, 0.4, 1.0), vec3(1.0, 0.8, 0.0), t);
+        FragColor = vec4(score_color, 1.0);
+        return;
+    }
     FragColor = vec4(color, 1.0);
 }
 )";
@@ -188,9 +314,21 @@ void render_point_cloud()
     glm::vec3 point_color(0.5f, 0.5f, 0.5f);
     glUniform3fv(glGetUniformLocation(shader_program, "color"), 1, glm::value_ptr(point_color));
 
-    glBindVertexArray(vao);
-    const std::vector<Point3D> &current_points = dbscan_applied ? filtered_points : original_points;
-    glDrawArrays(GL_POINTS, 0, current_points.size());
+    if (show_lof && lof_vis_count > 0)
+    {
+        // LOF 점수 색 (점수를 계산한 점만)
+        glUniform1i(glGetUniformLocation(shader_program, "useScore"), 1);
+        glUniform1f(glGetUniformLocation(shader_program, "scoreThreshold"), lof_threshold);
+        glBindVertexArray(lof_vao);
+        glDrawArrays(GL_POINTS, 0, lof_vis_count);
+        glUniform1i(glGetUniformLocation(shader_program, "useScore"), 0);
+    }
+    else
+    {
+        glBindVertexArray(vao);
+        const std::vector<Point3D> &current_points = dbscan_applied ? filtered_points : original_points;
+        glDrawArrays(GL_POINTS, 0, current_points.size());
+    }
 
     // 2. 바닥 포인트 (빨간색) - 덮어 그리기
     if (show_floor_vis && !floor_vis_points.empty())
@@ -210,47 +348,666 @@ void render_point_cloud()
 }
 
 // ========== DBSCAN 실행 ==========
+
+// 현재 결과에서 DBSCAN을 실행하는지 (그래프/증분/적응 방식은 원본 점 기준 캐시를 쓰므로 제외)
+bool dbscan_on_current_result()
+{
+    return dbscan_input == 3 && dbscan_applied && dbscan_method != 2 && dbscan_method != 5 && dbscan_method != 7;
+}
+
+// OPTICS 결과로 현재 파라미터의 레이블을 뽑을 수 있는지 (OPTICS 순서는 원본 점 전체 기준)
+bool optics_usable()
+{
+    return optics_ready && optics.min_points == min_points && epsilon <= optics.max_epsilon &&
+           !dbscan_on_current_result();
+}
+
+std::vector<bool> largest_cluster_mask(const std::vector<int> &labels);
+void apply_mask(const std::vector<bool> &mask, const std::string &suffix);
+
+// 캐시된 이웃 그래프로 DBSCAN (epsilon이 캐시보다 크면 다시 구축)
+std::vector<int> dbscan_with_graph()
+{
+    if (neighbor_graph.empty() || epsilon > neighbor_graph.epsilon)
+    {
+        neighbor_graph = NeighborGraph(); // 이전 그래프와 동시에 메모리에 올라가지 않도록 먼저 해제
+        NeighborGraph graph = build_neighbor_graph(original_points, *tree, epsilon, (size_t)graph_budget_mb * 1024 * 1024);
+
+        // 취소되면 일부 블록만 채워진 그래프라 캐시하지 않음
+        if (task_cancelled())
+            return std::vector<int>();
+
+        // 예산 초과로 구축하지 않았으면 그래프 없이 실행
+        if (graph.empty())
+        {
+            std::cout << "-> 격자 DBSCAN으로 대신 실행" << std::endl;
+            return dbscan_clustering_grid(original_points, *tree, epsilon, min_points);
+        }
+
+        neighbor_graph = std::move(graph);
+        std::cout << "이웃 그래프 구축: " << neighbor_graph.neighbors.size() << "개 간선, "
+                  << neighbor_graph.memory_bytes() / (1024.0 * 1024.0) << " MB" << std::endl;
+    }
+    else
+    {
+        std::cout << "이웃 그래프 재사용 (epsilon " << neighbor_graph.epsilon << ")" << std::endl;
+    }
+
+    std::vector<int> labels = dbscan_clustering_graph(neighbor_graph, epsilon, min_points);
+
+    // 그래프를 만든 뒤 예산을 줄였으면 캐시 해제
+    if (neighbor_graph.memory_bytes() > (size_t)graph_budget_mb * 1024 * 1024)
+    {
+        std::cout << "이웃 그래프가 예산(" << graph_budget_mb << " MB)을 넘어 해제" << std::endl;
+        neighbor_graph = NeighborGraph();
+    }
+
+    return labels;
+}
+
+// 밀도 적응 DBSCAN 레이블 (국소 거리 캐시가 없거나 MinPts가 바뀌었으면 먼저 계산)
+std::vector<int> dbscan_adaptive()
+{
+    if (local_scales_k != min_points || local_scales.size() != original_points.size())
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        local_scales = compute_local_scales(original_points, *tree, min_points);
+        local_scales_k = min_points;
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << "국소 거리 계산 (k = " << min_points << "): " << std::chrono::duration<float>(end - start).count()
+                  << " s" << std::endl;
+    }
+    else
+    {
+        std::cout << "국소 거리 재사용 (k = " << local_scales_k << ")" << std::endl;
+    }
+
+    // 계산 중 취소되면 캐시가 불완전하므로 버림
+    if (task_cancelled())
+    {
+        local_scales.clear();
+        local_scales_k = -1;
+        return std::vector<int>(original_points.size(), -1);
+    }
+
+    return dbscan_clustering_adaptive(original_points, *tree, local_scales, adaptive_scale, epsilon, min_points);
+}
+
+// 증분 DBSCAN 레이블 (엔진이 없거나 파라미터/점 수가 바뀌었으면 현재 점 전체로 구축)
+std::vector<int> dbscan_incremental()
+{
+    if (!incremental || incremental->get_radius() != epsilon || incremental->get_min_points() != min_points ||
+        incremental->size() != (int)original_points.size())
+    {
+        delete incremental;
+        incremental = new IncrementalDbscan(epsilon, min_points);
+        incremental->insert(original_points);
+    }
+
+    // 구축 중 취소되면 다음에 다시 구축 (레이블은 어차피 버려짐)
+    if (task_cancelled())
+    {
+        delete incremental;
+        incremental = nullptr;
+        return std::vector<int>(original_points.size(), -1);
+    }
+
+    return incremental->labels();
+}
+
+// 상태(캐시)가 없는 방식의 DBSCAN 후 가장 큰 클러스터 마스크
+// points/tree는 원본 점 또는 다운샘플링한 점
+std::vector<bool> stateless_dbscan_mask(const std::vector<Point3D> &points, KDTree &point_tree)
+{
+    if (dbscan_method == 6)
+    {
+        std::vector<int> labels = dbscan_clustering_multiprocess(points, epsilon, min_points,
+                                                                 process_workers, &process_stats);
+        if (labels.empty() && !task_cancelled())
+        {
+            std::cout << "-> 격자 DBSCAN으로 대신 실행" << std::endl;
+            labels = dbscan_clustering_grid(points, point_tree, epsilon, min_points);
+        }
+        return largest_cluster_mask(labels);
+    }
+
+    // 나머지 방식은 트리 전체를 탐색하므로 남은 서브트리를 먼저 병렬 구축
+    point_tree.build_all();
+    if (dbscan_method == 4)
+    {
+        return largest_cluster_mask(dbscan_clustering_sampled(points, point_tree, epsilon, min_points,
+                                                              sample_voxel_size));
+    }
+    if (dbscan_method == 3)
+    {
+        // 다른 클러스터는 레이블링하지 않음
+        return dbscan_largest_cluster(points, point_tree, epsilon, min_points);
+    }
+    return largest_cluster_mask(dbscan_method == 1
+                                    ? dbscan_clustering_grid(points, point_tree, epsilon, min_points)
+                                    : dbscan_clustering_parallel(points, point_tree, epsilon, min_points));
+}
+
+void clear_voxel_subsample()
+{
+    delete voxel_tree;
+    voxel_tree = nullptr;
+    voxel_subsample = PointSubsample();
+    voxel_subsample_size = -1.0f;
+}
+
+void clear_uniform_sample()
+{
+    delete uniform_sample_tree;
+    uniform_sample_tree = nullptr;
+    uniform_sample = PointSubsample();
+}
+
+// 법선은 계산할 때의 남은 점 집합으로 이웃을 찾으므로 집합이 바뀌면 버림
+void clear_point_normals()
+{
+    point_normals = PointNormals();
+    normal_count = 0;
+}
+
+// 점군이 바뀌면(로드/추가) 점 인덱스에 묶인 캐시를 모두 버림
+// 증분 DBSCAN 엔진은 추가 시 새 점만 삽입하므로 여기서 지우지 않음
+void clear_derived_caches()
+{
+    optics_ready = false;
+    neighbor_graph = NeighborGraph();
+    sample_quality_ready = false;
+    epsilon_curve.clear();
+    floor_curve.clear();
+    k_distance = KDistanceCurve();
+    k_distance_plot.clear();
+    local_scales.clear();
+    local_scales_k = -1;
+    sor_stats = OutlierFilterStats();
+    ror_stats = OutlierFilterStats();
+    clear_voxel_subsample();
+    clear_uniform_sample();
+    lof_graph = KnnGraph();
+    lof_scores.clear();
+    lof_active.clear();
+    show_lof = false;
+    clear_point_normals();
+}
+
+// 축소 점에서 DBSCAN 후 원본 점 마스크로 되돌림
+std::vector<bool> subsample_dbscan_mask(const PointSubsample &subsample, KDTree &subsample_tree)
+{
+    return expand_subsample_mask(subsample, stateless_dbscan_mask(subsample.points, subsample_tree));
+}
+
+// 복셀 점에서 DBSCAN (복셀 점과 트리는 크기/방식이 바뀔 때만 다시 만듦)
+std::vector<bool> downsampled_dbscan_mask()
+{
+    if (voxel_subsample_size != downsample_voxel_size || voxel_subsample_nearest != downsample_nearest)
+    {
+        clear_voxel_subsample();
+        voxel_subsample = voxel_downsample(original_points, downsample_voxel_size, downsample_nearest);
+        if (task_cancelled())
+        {
+            clear_voxel_subsample();
+            return std::vector<bool>(original_points.size(), false);
+        }
+        voxel_tree = new KDTree(voxel_subsample.points, true);
+        voxel_subsample_size = downsample_voxel_size;
+        voxel_subsample_nearest = downsample_nearest;
+    }
+    else
+    {
+        std::cout << "복셀 점 재사용 (" << voxel_subsample.points.size() << "개)" << std::endl;
+    }
+
+    return subsample_dbscan_mask(voxel_subsample, *voxel_tree);
+}
+
+// 현재 파라미터로 DBSCAN 후 가장 큰 클러스터 마스크 (백그라운드 작업에서 실행)
+std::vector<bool> compute_dbscan_mask()
+{
+    std::vector<bool> mask;
+    if (optics_usable())
+    {
+        // OPTICS 순서에서 바로 추출 (선형 스캔)
+        mask = largest_cluster_mask(extract_dbscan_labels(optics, epsilon));
+    }
+    else if (dbscan_input == 1 && dbscan_method != 2 && dbscan_method != 5 && dbscan_method != 7)
+    {
+        mask = downsampled_dbscan_mask();
+    }
+    else if (dbscan_input == 2 && !uniform_sample.empty() && dbscan_method != 2 && dbscan_method != 5 &&
+             dbscan_method != 7)
+    {
+        // 샘플에 없는 원본 점은 결과에서 빠짐
+        mask = subsample_dbscan_mask(uniform_sample, *uniform_sample_tree);
+    }
+    else if (dbscan_on_current_result())
+    {
+        // 현재 결과에 없는 원본 점은 결과에서 빠짐 (작업 중에는 결과를 바꾸는 버튼이 비활성화됨)
+        PointSubsample current = make_index_subsample(original_points, filtered_indices);
+        KDTree current_tree(current.points, true);
+        mask = subsample_dbscan_mask(current, current_tree);
+    }
+    else
+    {
+        // 그래프/증분/적응 방식은 원본 점 기준 캐시를 쓰므로 다운샘플링하지 않음
+        // 트리를 쓰는 방식만 남은 서브트리를 먼저 병렬 구축 (증분 방식은 자체 격자를 써서 추가 후에도 트리를 만들지 않음)
+        if (dbscan_method == 7)
+        {
+            tree->build_all();
+            mask = largest_cluster_mask(dbscan_adaptive());
+        }
+        else if (dbscan_method == 5)
+        {
+            mask = largest_cluster_mask(dbscan_incremental());
+        }
+        else if (dbscan_method == 2)
+        {
+            tree->build_all();
+            mask = largest_cluster_mask(dbscan_with_graph());
+        }
+        else
+        {
+            mask = stateless_dbscan_mask(original_points, *tree);
+        }
+    }
+
+    return mask;
+}
+
 void apply_dbscan()
 {
     std::cout << "\nDBSCAN 실행 중..." << std::endl;
     std::cout << "Epsilon: " << epsilon << ", MinPts: " << min_points << std::endl;
 
-    auto start_time = std::chrono::high_resolution_clock::now();
+    // OPTICS 선형 스캔은 빨라서 바로 적용 (슬라이더로 연속 조절)
+    if (optics_usable())
+    {
+        auto start_time = std::chrono::high_resolution_clock::now();
+        std::vector<bool> mask = compute_dbscan_mask();
+        auto end_time = std::chrono::high_resolution_clock::now();
+        last_execution_time = std::chrono::duration<float>(end_time - start_time).count();
+        std::cout << "실행 시간: " << last_execution_time << " s" << std::endl;
+        apply_mask(mask, "_dbscan");
+        return;
+    }
+
+    // 현재 결과에서 실행하면 앞 단계 이름 뒤에 붙임 (예: _ror_dbscan)
+    std::string suffix = dbscan_on_current_result() ? result_suffix + "_dbscan" : "_dbscan";
+    job.start("DBSCAN", [suffix]()
+              {
+                  auto start_time = std::chrono::high_resolution_clock::now();
+                  std::vector<bool> mask = compute_dbscan_mask();
+                  auto end_time = std::chrono::high_resolution_clock::now();
+                  float seconds = std::chrono::duration<float>(end_time - start_time).count();
+
+                  return BackgroundJob::Apply([mask, suffix, seconds]()
+                                              {
+                                                  last_execution_time = seconds;
+                                                  std::cout << "실행 시간: " << last_execution_time << " s" << std::endl;
+                                                  apply_mask(mask, suffix);
+                                              });
+              });
+}
+
+// 이상점 필터/LOF/법선의 대상: 현재 결과(바닥 제거 포함)의 점, 결과가 없으면 전체 점
+std::vector<bool> current_result_mask()
+{
+    if (!dbscan_applied)
+        return std::vector<bool>(original_points.size(), true);
 
-    std::vector<int> labels = dbscan_clustering_kdtree(original_points, *tree, epsilon, min_points);
-    current_labels = labels;
+    std::vector<bool> active(original_points.size(), false);
+    for (int idx : filtered_indices)
+    {
+        active[idx] = true;
+    }
+    return active;
+}
 
-    auto end_time = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
-    last_execution_time = duration.count() / 1000.0f;
+// 통계적 이상점 제거: DBSCAN을 적용했으면 남은 점만, 아니면 전체 점 대상
+void apply_statistical_filter()
+{
+    std::cout << "\n통계적 이상점 제거 실행 중..." << std::endl;
+
+    int k = sor_k;
+    float std_ratio = sor_std_ratio;
+    std::vector<bool> active = current_result_mask();
+
+    job.start("Statistical Filter", [=]()
+              {
+                  auto start_time = std::chrono::high_resolution_clock::now();
+                  OutlierFilterStats stats;
+                  std::vector<bool> mask = statistical_outlier_mask(original_points, *tree, active, k, std_ratio, &stats);
+                  auto end_time = std::chrono::high_resolution_clock::now();
+                  float seconds = std::chrono::duration<float>(end_time - start_time).count();
+
+                  return BackgroundJob::Apply([mask, stats, seconds]()
+                                              {
+                                                  sor_stats = stats;
+                                                  last_execution_time = seconds;
+                                                  std::cout << "실행 시간: " << last_execution_time << " s" << std::endl;
+                                                  apply_mask(mask, result_suffix + "_sor");
+                                              });
+              });
+}
 
-    std::cout << "실행 시간: " << last_execution_time << " s" << std::endl;
+// 반경 이상점 제거: 대상은 통계적 이상점 제거와 같음
+void apply_radius_filter()
+{
+    std::cout << "\n반경 이상점 제거 실행 중..." << std::endl;
+
+    float radius = ror_radius;
+    int min_neighbors = ror_min_neighbors;
+    std::vector<bool> active = current_result_mask();
+
+    job.start("Radius Filter", [=]()
+              {
+                  auto start_time = std::chrono::high_resolution_clock::now();
+                  OutlierFilterStats stats;
+                  std::vector<bool> mask = radius_outlier_mask(original_points, *tree, active, radius, min_neighbors, &stats);
+                  auto end_time = std::chrono::high_resolution_clock::now();
+                  float seconds = std::chrono::duration<float>(end_time - start_time).count();
+
+                  return BackgroundJob::Apply([mask, stats, seconds]()
+                                              {
+                                                  ror_stats = stats;
+                                                  last_execution_time = seconds;
+                                                  std::cout << "실행 시간: " << last_execution_time << " s" << std::endl;
+                                                  apply_mask(mask, result_suffix + "_ror");
+                                              });
+              });
+}
 
-    // 가장 큰 클러스터 찾기
-    std::map<int, int> cluster_sizes;
+// 균일 샘플링 결과 (작업 스레드에서 만들고, 적용되지 않고 버려지면 소멸자가 트리 해제)
+struct UniformSampleResult
+{
+    PointSubsample sample;
+    KDTree *tree = nullptr;
+
+    ~UniformSampleResult() { delete tree; }
+};
+
+// pick이 고른 원본 인덱스를 균일 샘플로 저장하고 현재 결과로 표시 (바닥 제거/저장 입력, DBSCAN Input = Sample)
+void start_uniform_sample(const std::string &name, const std::string &suffix, std::function<std::vector<int>()> pick)
+{
+    job.start(name, [suffix, pick]()
+              {
+                  auto start_time = std::chrono::high_resolution_clock::now();
+                  auto result = std::make_shared<UniformSampleResult>();
+                  result->sample = make_index_subsample(original_points, pick());
+                  result->tree = new KDTree(result->sample.points, true);
+                  auto end_time = std::chrono::high_resolution_clock::now();
+                  float seconds = std::chrono::duration<float>(end_time - start_time).count();
+
+                  return BackgroundJob::Apply([result, suffix, seconds]()
+                                              {
+                                                  clear_uniform_sample();
+                                                  uniform_sample = std::move(result->sample);
+                                                  uniform_sample_tree = result->tree;
+                                                  result->tree = nullptr;
+
+                                                  last_execution_time = seconds;
+                                                  std::cout << "실행 시간: " << last_execution_time << " s" << std::endl;
+                                                  std::vector<bool> all(uniform_sample.points.size(), true);
+                                                  apply_mask(expand_subsample_mask(uniform_sample, all), suffix);
+                                              });
+              });
+}
+
+void apply_farthest_point_sample()
+{
+    std::cout << "\n가장 먼 점 샘플링 실행 중..." << std::endl;
+    int count = fps_count;
+    start_uniform_sample("Farthest Point", "_fps", [count]()
+                         { return farthest_point_sample(original_points, count); });
+}
+
+void apply_poisson_disk_sample()
+{
+    std::cout << "\n포아송 디스크 샘플링 실행 중..." << std::endl;
+    float spacing = poisson_spacing;
+    start_uniform_sample("Poisson Disk", "_poisson", [spacing]()
+                         { return poisson_disk_sample(original_points, spacing); });
+}
+
+// ========== LOF ==========
+// 점수가 기준 이상인 점 수 (기준 슬라이더를 움직일 때)
+void count_lof_above()
+{
+    lof_above = 0;
+    for (size_t i = 0; i < lof_scores.size(); i++)
+    {
+        if (lof_active[i] && lof_scores[i] >= lof_threshold)
+            lof_above++;
+    }
+}
+
+// 점수를 계산한 점의 위치 + 점수로 LOF 표시 버퍼 갱신
+void update_lof_buffer()
+{
+    std::vector<float> data;
+    data.reserve(original_points.size() * 4);
+    for (size_t i = 0; i < lof_scores.size(); i++)
+    {
+        if (!lof_active[i])
+            continue;
+        data.push_back(original_points[i].x);
+        data.push_back(original_points[i].y);
+        data.push_back(original_points[i].z);
+        data.push_back(lof_scores[i]);
+    }
+    lof_vis_count = data.size() / 4;
+
+    if (lof_vao == 0)
+    {
+        glGenVertexArrays(1, &lof_vao);
+        glGenBuffers(1, &lof_vbo);
+    }
+
+    glBindVertexArray(lof_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, lof_vbo);
+    glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(float), data.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void *)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void *)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+// LOF 점수 계산: 대상은 이상점 필터와 같음 (현재 결과 또는 전체 점)
+void compute_lof()
+{
+    std::cout << "\nLOF 계산 중..." << std::endl;
+
+    int k = lof_k;
+    std::vector<bool> active = current_result_mask();
+
+    job.start("LOF", [k, active]()
+              {
+                  auto start_time = std::chrono::high_resolution_clock::now();
+
+                  // 대상 점이 같고 k가 그래프 이하면 그래프 재사용 (작업 중에는 그래프를 바꾸는 곳이 없음)
+                  if (lof_graph.k < k || lof_graph.active != active)
+                  {
+                      lof_graph = KnnGraph();
+                      KnnGraph graph = build_knn_graph(original_points, *tree, active, k);
+                      if (task_cancelled())
+                          return BackgroundJob::Apply();
+                      lof_graph = std::move(graph);
+                  }
+                  else
+                  {
+                      std::cout << "k-최근접 그래프 재사용 (k = " << lof_graph.k << ")" << std::endl;
+                  }
+
+                  std::vector<float> scores = local_outlier_factor(original_points, lof_graph, k);
+                  auto end_time = std::chrono::high_resolution_clock::now();
+                  float seconds = std::chrono::duration<float>(end_time - start_time).count();
+
+                  return BackgroundJob::Apply([scores, active, seconds]()
+                                              {
+                                                  lof_scores = scores;
+                                                  lof_active = active;
+                                                  last_execution_time = seconds;
+                                                  std::cout << "실행 시간: " << last_execution_time << " s" << std::endl;
+                                                  count_lof_above();
+                                                  update_lof_buffer();
+                                                  show_lof = true;
+                                              });
+              });
+}
+
+// 점수가 기준 이상인 점 제거
+void remove_lof_outliers()
+{
+    std::vector<bool> keep = lof_active;
+    for (size_t i = 0; i < keep.size(); i++)
+    {
+        if (keep[i] && lof_scores[i] >= lof_threshold)
+            keep[i] = false;
+    }
+    std::cout << "\nLOF " << lof_threshold << " 이상 제거" << std::endl;
+    apply_mask(keep, result_suffix + "_lof");
+}
+
+// ========== 법선 추정 ==========
+// 대상은 이상점 필터와 같음, 법선은 점군 경계 상자 중심(실내 스캔이면 스캐너 쪽)을 향하게 맞춤
+void compute_normals()
+{
+    if (original_points.empty())
+        return;
+
+    std::cout << "\n법선 추정 중..." << std::endl;
+
+    int k = normal_k;
+    std::vector<bool> active = current_result_mask();
+
+    job.start("Normals", [k, active]()
+              {
+                  auto start_time = std::chrono::high_resolution_clock::now();
+
+                  Point3D lo = original_points[0], hi = original_points[0];
+                  for (const auto &p : original_points)
+                  {
+                      lo.x = std::min(lo.x, p.x);
+                      lo.y = std::min(lo.y, p.y);
+                      lo.z = std::min(lo.z, p.z);
+                      hi.x = std::max(hi.x, p.x);
+                      hi.y = std::max(hi.y, p.y);
+                      hi.z = std::max(hi.z, p.z);
+                  }
+                  Point3D center((lo.x + hi.x) * 0.5f, (lo.y + hi.y) * 0.5f, (lo.z + hi.z) * 0.5f);
+
+                  auto normals = std::make_shared<PointNormals>(estimate_normals(original_points, *tree, active, k, center));
+                  auto end_time = std::chrono::high_resolution_clock::now();
+                  float seconds = std::chrono::duration<float>(end_time - start_time).count();
+
+                  return BackgroundJob::Apply([normals, seconds]()
+                                              {
+                                                  point_normals = std::move(*normals);
+
+                                                  // 법선이 있는 점의 평균 곡률
+                                                  double sum = 0.0;
+                                                  normal_count = 0;
+                                                  for (size_t i = 0; i < point_normals.size(); i++)
+                                                  {
+                                                      if (point_normals.nx[i] == 0.0f && point_normals.ny[i] == 0.0f && point_normals.nz[i] == 0.0f)
+                                                          continue;
+                                                      sum += point_normals.curvature[i];
+                                                      normal_count++;
+                                                  }
+                                                  mean_curvature = normal_count > 0 ? sum / normal_count : 0.0f;
+
+                                                  last_execution_time = seconds;
+                                                  std::cout << "실행 시간: " << last_execution_time << " s" << std::endl;
+                                              });
+              });
+}
+
+// 곡률이 기준보다 큰 점 제거 (모서리/흩어진 노이즈처럼 표면 변화가 큰 점)
+// 대상은 현재 결과, 법선을 추정하지 못한 점은 곡률이 0이라 남음
+void apply_curvature_filter()
+{
+    std::vector<bool> keep = current_result_mask();
+    int removed = 0;
+    for (size_t i = 0; i < point_normals.size(); i++)
+    {
+        if (keep[i] && point_normals.curvature[i] > max_curvature)
+        {
+            keep[i] = false;
+            removed++;
+        }
+    }
+    std::cout << "\n곡률 " << max_curvature << " 초과 제거: " << removed << "개" << std::endl;
+    apply_mask(keep, result_suffix + "_curv");
+}
+
+// OPTICS 계산 (현재 MinPts, Max Epsilon 기준)
+void build_optics()
+{
+    tree->build_all();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    optics = compute_optics(original_points, *tree, optics_max_epsilon, min_points);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    optics_ready = true;
+    std::cout << "OPTICS 계산 시간: " << std::chrono::duration<float>(end - start).count() << " s" << std::endl;
+}
+
+// 레이블에서 가장 큰 클러스터의 점만 true (클러스터 번호는 0부터 연속)
+std::vector<bool> largest_cluster_mask(const std::vector<int> &labels)
+{
+    std::vector<int> cluster_sizes;
     for (int label : labels)
     {
+        if (label < 0)
+            continue;
+        if (label >= (int)cluster_sizes.size())
+            cluster_sizes.resize(label + 1, 0);
         cluster_sizes[label]++;
     }
 
     int largest_cluster = -1;
     int largest_size = 0;
-    for (auto &[id, size] : cluster_sizes)
+    for (int id = 0; id < (int)cluster_sizes.size(); id++)
     {
-        if (id != -1 && size > largest_size)
+        if (cluster_sizes[id] > largest_size)
         {
             largest_cluster = id;
-            largest_size = size;
+            largest_size = cluster_sizes[id];
         }
     }
 
+    std::vector<bool> mask(labels.size(), false);
+    for (size_t i = 0; i < labels.size(); i++)
+    {
+        mask[i] = labels[i] != -1 && labels[i] == largest_cluster;
+    }
+    return mask;
+}
+
+// DBSCAN 결과 마스크로 화면/상태 갱신
+void apply_mask(const std::vector<bool> &mask, const std::string &suffix)
+{
+    dbscan_mask = mask;
+    result_suffix = suffix;
+    show_lof = false;
+    clear_point_normals();
+
+    // 마스크로 점을 다시 만드므로 이전 바닥 제거 결과는 사라짐
+    floor_removed = false;
+
     // 필터링된 포인트 생성 + 인덱스 저장
     filtered_points.clear();
     filtered_indices.clear();
 
-    for (size_t i = 0; i < labels.size(); i++)
+    for (size_t i = 0; i < mask.size(); i++)
     {
-        if (labels[i] == largest_cluster)
+        if (mask[i])
         {
             filtered_points.push_back(original_points[i]);
             filtered_indices.push_back(i); // 인덱스 저장
@@ -266,6 +1023,80 @@ void apply_dbscan()
     std::cout << "완료! 제거된 점: " << removed_points << std::endl;
 }
 
+// ========== 반경별 곡선 ==========
+void compute_epsilon_curve()
+{
+    // 현재 epsilon의 1/8 ~ 2배
+    epsilon_curve_radii.clear();
+    for (int k = 0; k < CURVE_SAMPLES; k++)
+    {
+        epsilon_curve_radii.push_back(epsilon * (k + 1) / 8.0f);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    epsilon_curve = core_ratio_curve(original_points, *tree, epsilon_curve_radii, min_points);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    std::cout << "Epsilon 곡선 계산: " << std::chrono::duration<float>(end - start).count() << " s" << std::endl;
+}
+
+// MinPts번째 이웃 거리 곡선 (표본이 크면 오래 걸리므로 백그라운드 작업으로 실행)
+void compute_k_distance()
+{
+    std::cout << "\nk-거리 곡선 계산 중..." << std::endl;
+
+    int k = min_points;
+    float fraction = k_distance_sample_percent / 100.0f;
+
+    job.start("K-Distance", [k, fraction]()
+              {
+                  auto start = std::chrono::high_resolution_clock::now();
+                  auto curve = std::make_shared<KDistanceCurve>(compute_k_distance_curve(original_points, *tree, k, fraction));
+                  auto end = std::chrono::high_resolution_clock::now();
+                  float seconds = std::chrono::duration<float>(end - start).count();
+
+                  return BackgroundJob::Apply([curve, seconds]()
+                                              {
+                                                  k_distance = std::move(*curve);
+                                                  k_distance_plot.clear();
+                                                  int count = k_distance.distances.size();
+                                                  if (count == 0)
+                                                      return;
+
+                                                  for (int k = 0; k < K_DISTANCE_PLOT_SAMPLES; k++)
+                                                  {
+                                                      k_distance_plot.push_back(k_distance.distances[(size_t)(count - 1) * k / (K_DISTANCE_PLOT_SAMPLES - 1)]);
+                                                  }
+
+                                                  std::cout << "k-거리 곡선 계산 (표본 " << count << "개): " << seconds
+                                                            << " s, 추천 Epsilon: " << k_distance.suggested_epsilon << std::endl;
+                                              });
+              });
+}
+
+void compute_floor_curve()
+{
+    if (!dbscan_applied)
+    {
+        std::cout << "먼저 DBSCAN을 실행하세요." << std::endl;
+        return;
+    }
+
+    // Search Radius 슬라이더 범위 (0.01 ~ 1.0)
+    floor_curve_radii.clear();
+    for (int k = 0; k < CURVE_SAMPLES; k++)
+    {
+        floor_curve_radii.push_back(0.01f + (1.0f - 0.01f) * k / (CURVE_SAMPLES - 1));
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    floor_curve = floor_removal_curve(original_points, *tree, dbscan_mask, floor_curve_radii,
+                                      floor_ratio, mid_start, mid_end, min_points_above);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    std::cout << "Search Radius 곡선 계산: " << std::chrono::duration<float>(end - start).count() << " s" << std::endl;
+}
+
 // ========== 결과 저장 ==========
 void save_result()
 {
@@ -283,40 +1114,35 @@ void save_result()
         base_name = base_name.substr(0, dot_pos);
     }
 
-    std::string filename;
+    // filtered_indices를 사용해서 is_noise 배열 생성 (빠름!)
+    std::vector<bool> is_noise(original_points.size(), true);
+    for (int idx : filtered_indices)
+    {
+        is_noise[idx] = false;
+    }
 
+    // 적용한 단계 순서대로 이름 (DBSCAN -> 바닥 제거면 기존처럼 _dbscan_floor)
+    std::string filename = "../model/" + base_name + result_suffix + ".obj";
     if (floor_removed)
     {
-        // 바닥 제거까지 완료된 경우
         std::cout << "\n바닥 제거 결과 저장 중..." << std::endl;
-        filename = "../model/" + base_name + "_dbscan_floor.obj";
-
-        // filtered_indices를 사용해서 is_noise 배열 생성 (빠름!)
-        std::vector<bool> is_noise(original_points.size(), true);
-        for (int idx : filtered_indices)
-        {
-            is_noise[idx] = false;
-        }
-
-        save_filtered_mesh(mesh, is_noise, filename);
-        std::cout << "저장 완료: " << filename << std::endl;
     }
     else
     {
-        // DBSCAN만 적용된 경우
-        std::cout << "\nDBSCAN 결과 저장 중..." << std::endl;
-
-        // filtered_indices를 사용해서 is_noise 배열 생성
-        std::vector<bool> is_noise(original_points.size(), true);
-        for (int idx : filtered_indices)
-        {
-            is_noise[idx] = false;
-        }
-
-        filename = "../model/" + base_name + "_dbscan.obj";
-        save_filtered_mesh(mesh, is_noise, filename);
-        std::cout << "저장 완료: " << filename << std::endl;
+        std::cout << "\n필터링 결과 저장 중..." << std::endl;
     }
+
+    // 파일 쓰기는 작업 스레드에서 (작업 중에는 메시를 바꾸는 버튼이 비활성화됨)
+    saved_missing_normals = 0;
+    job.start("Save Result", [is_noise, filename]()
+              {
+                  int missing = save_filtered_mesh(mesh, is_noise, filename, point_normals.empty() ? nullptr : &point_normals);
+                  return BackgroundJob::Apply([filename, missing]()
+                                              {
+                                                  saved_missing_normals = missing;
+                                                  std::cout << "저장 완료: " << filename << std::endl;
+                                              });
+              });
 }
 
 // ========== 키 입력 처리 ==========
@@ -402,21 +1228,70 @@ void cursor_position_callback(GLFWwindow *window, double xpos, double ypos)
 void reset_to_original()
 {
     dbscan_applied = false;
+    result_suffix.clear();
     removed_points = 0;
     last_execution_time = 0.0f;
     show_floor_vis = false;
     floor_vis_points.clear();
     floor_removed = false;
     filtered_indices.clear(); // 인덱스도 초기화
+    clear_point_normals();
     update_point_cloud_buffer(original_points);
 }
 
 // ========== 새 OBJ 파일 로드 ==========
+// 작업 스레드에서 읽은 모델 (적용되지 않고 버려지면 소멸자가 해제)
+struct LoadedModel
+{
+    OBJMesh *mesh = nullptr;
+    KDTree *tree = nullptr;
+    std::vector<Point3D> points;
+
+    ~LoadedModel()
+    {
+        if (mesh)
+            free_mesh(mesh);
+        delete tree;
+    }
+};
+
+void apply_loaded_model(LoadedModel &loaded, const std::string &path_str);
+
 void load_new_obj(const char *filepath)
 {
     std::cout << "\n새 OBJ 파일 로딩 중: " << filepath << std::endl;
 
     std::string path_str(filepath);
+    job.start("Load OBJ", [path_str]()
+              {
+                  // 1. 새 OBJ 로드 + Point cloud 생성
+                  auto loaded = std::make_shared<LoadedModel>();
+                  loaded->mesh = load_obj(path_str);
+                  if (!loaded->mesh)
+                  {
+                      if (!task_cancelled())
+                          std::cerr << "OBJ 로드 실패: " << path_str << std::endl;
+                      return BackgroundJob::Apply();
+                  }
+
+                  for (const auto &v : loaded->mesh->vertices)
+                  {
+                      loaded->points.push_back(Point3D(v.x, v.y, v.z));
+                  }
+                  std::cout << "총 " << loaded->points.size() << "개 포인트 로드" << std::endl;
+
+                  // 2. KD-Tree (상위 레벨만 분할, 하위 트리는 처음 탐색할 때 구축)
+                  loaded->tree = new KDTree(loaded->points, true);
+                  std::cout << "KD-Tree 상위 레벨 분할 완료 (하위 트리는 필요할 때 구축)" << std::endl;
+
+                  return BackgroundJob::Apply([loaded, path_str]()
+                                              { apply_loaded_model(*loaded, path_str); });
+              });
+}
+
+// 읽은 모델로 교체 (주 스레드)
+void apply_loaded_model(LoadedModel &loaded, const std::string &path_str)
+{
     size_t last_slash = path_str.find_last_of("/\\");
     if (last_slash != std::string::npos)
     {
@@ -427,47 +1302,32 @@ void load_new_obj(const char *filepath)
         current_obj_name = path_str;
     }
 
-    // 1. 기존 데이터 정리
+    // 1. 기존 데이터 정리 + 교체
     if (mesh)
     {
         free_mesh(mesh);
     }
-    if (tree)
-    {
-        delete tree;
-    }
-    original_points.clear();
+    delete tree;
+    mesh = loaded.mesh;
+    tree = loaded.tree;
+    loaded.mesh = nullptr;
+    loaded.tree = nullptr;
+    original_points.swap(loaded.points);
     filtered_points.clear();
-
-    // 2. 새 OBJ 로드
-    mesh = load_obj(filepath);
-    if (!mesh)
-    {
-        std::cerr << "OBJ 로드 실패: " << filepath << std::endl;
-        return;
-    }
-
-    // 3. Point cloud 생성
-    for (const auto &v : mesh->vertices)
-    {
-        original_points.push_back(Point3D(v.x, v.y, v.z));
-    }
+    clear_derived_caches();
+    delete incremental;
+    incremental = nullptr;
     total_points = original_points.size();
-    std::cout << "총 " << total_points << "개 포인트 로드" << std::endl;
-
-    // 4. KD-Tree
-    std::cout << "KD-Tree 구축 중..." << std::endl;
-    tree = new KDTree(original_points);
-    std::cout << "KD-Tree 구축 완료!" << std::endl;
 
-    // 5. 상태 초기화
+    // 2. 상태 초기화
     dbscan_applied = false;
+    result_suffix.clear();
     removed_points = 0;
     last_execution_time = 0.0f;
     show_floor_vis = false;
     floor_vis_points.clear();
 
-    // 6. OpenGL 버퍼 업데이트
+    // 3. OpenGL 버퍼 업데이트
     update_point_cloud_buffer(original_points);
 
     std::cout << "새 모델 로드 완료!" << std::endl;
@@ -496,6 +1356,184 @@ void open_file_dialog()
     }
 }
 
+// ========== OBJ 추가 ==========
+void apply_appended_model(LoadedModel &merged, size_t added_count);
+
+// 선택한 OBJ의 정점/면을 현재 모델 뒤에 붙임 (인덱스는 기존 정점 수만큼 밀림)
+// 읽기와 병합은 작업 스레드에서 현재 메시의 복사본에 하고 주 스레드에서는 교체만 함
+// 증분 DBSCAN 엔진이 있으면 새 점만 삽입하고, 증분 방식으로 DBSCAN을 적용한 상태면 바로 다시 적용
+void append_obj_dialog()
+{
+    if (!mesh)
+    {
+        open_file_dialog();
+        return;
+    }
+
+    nfdchar_t *outPath = NULL;
+    nfdfilteritem_t filters[1] = {{"OBJ Files", "obj"}};
+
+    nfdresult_t result = NFD_OpenDialog(&outPath, filters, 1, NULL);
+    if (result != NFD_OKAY)
+    {
+        if (result == NFD_ERROR)
+            std::cerr << "에러: " << NFD_GetError() << std::endl;
+        return;
+    }
+
+    std::string path_str(outPath);
+    NFD_FreePath(outPath);
+    std::cout << "\nOBJ 추가 중: " << path_str << std::endl;
+
+    // 작업 중에는 메시/점군/엔진을 바꾸는 버튼이 비활성화됨
+    job.start("Append OBJ", [path_str]()
+              {
+                  OBJMesh *added = load_obj(path_str);
+                  if (!added)
+                  {
+                      if (!task_cancelled())
+                          std::cerr << "OBJ 로드 실패: " << path_str << std::endl;
+                      return BackgroundJob::Apply();
+                  }
+
+                  // 1. 메시 병합 (현재 메시의 복사본 뒤에 붙임)
+                  auto merged = std::make_shared<LoadedModel>();
+                  merged->mesh = new OBJMesh(*mesh);
+                  OBJMesh *target = merged->mesh;
+                  int vertex_offset = target->vertices.size();
+                  int texcoord_offset = target->texcoords.size();
+                  int normal_offset = target->normals.size();
+                  for (Face face : added->faces)
+                  {
+                      for (int k = 0; k < 3; k++)
+                      {
+                          face.v[k] += vertex_offset;
+                          if (face.vt[k] >= 0)
+                              face.vt[k] += texcoord_offset;
+                          if (face.vn[k] >= 0)
+                              face.vn[k] += normal_offset;
+                      }
+                      target->faces.push_back(face);
+                  }
+                  target->vertices.insert(target->vertices.end(), added->vertices.begin(), added->vertices.end());
+                  target->texcoords.insert(target->texcoords.end(), added->texcoords.begin(), added->texcoords.end());
+                  target->normals.insert(target->normals.end(), added->normals.begin(), added->normals.end());
+                  target->has_vertex_colors = target->has_vertex_colors || added->has_vertex_colors;
+
+                  std::vector<Point3D> new_points;
+                  for (const auto &v : added->vertices)
+                  {
+                      new_points.push_back(Point3D(v.x, v.y, v.z));
+                  }
+                  free_mesh(added);
+
+                  // 2. 점군 + 트리 (점 순서가 바뀌므로 트리는 다시 만듦, 상위 레벨만 분할)
+                  merged->points = original_points;
+                  merged->points.insert(merged->points.end(), new_points.begin(), new_points.end());
+                  merged->tree = new KDTree(merged->points, true);
+
+                  // 3. 증분 DBSCAN: 새 점만 삽입
+                  //    취소되면 엔진을 버림 (삽입 뒤 적용 전에 취소되면 점 수가 달라 다음 DBSCAN에서 다시 구축)
+                  if (incremental)
+                  {
+                      auto start = std::chrono::high_resolution_clock::now();
+                      incremental->insert(new_points);
+                      auto end = std::chrono::high_resolution_clock::now();
+                      if (task_cancelled())
+                      {
+                          delete incremental;
+                          incremental = nullptr;
+                          return BackgroundJob::Apply();
+                      }
+                      std::cout << "증분 DBSCAN 갱신 시간: " << std::chrono::duration<float>(end - start).count() << " s" << std::endl;
+                  }
+
+                  size_t added_count = new_points.size();
+                  return BackgroundJob::Apply([merged, added_count]()
+                                              { apply_appended_model(*merged, added_count); });
+              });
+}
+
+// 병합한 모델로 교체 (주 스레드)
+void apply_appended_model(LoadedModel &merged, size_t added_count)
+{
+    free_mesh(mesh);
+    delete tree;
+    mesh = merged.mesh;
+    tree = merged.tree;
+    merged.mesh = nullptr;
+    merged.tree = nullptr;
+    original_points.swap(merged.points);
+    total_points = original_points.size();
+    clear_derived_caches();
+
+    std::cout << added_count << "개 포인트 추가, 총 " << total_points << "개" << std::endl;
+
+    if (dbscan_applied && dbscan_method == 5)
+    {
+        apply_dbscan();
+    }
+    else
+    {
+        reset_to_original();
+    }
+}
+
+// ========== 파일 타일 DBSCAN ==========
+// 선택한 OBJ를 메모리 예산 안에서 타일 단위로 처리 (현재 모델과 무관)
+// 결과: ../model/<이름>_labels.bin (정점별 int32 레이블), ../model/<이름>_dbscan_tiled.obj (가장 큰 클러스터 정점)
+void tiled_dbscan_file()
+{
+    nfdchar_t *outPath = NULL;
+    nfdfilteritem_t filters[1] = {{"OBJ Files", "obj"}};
+
+    nfdresult_t result = NFD_OpenDialog(&outPath, filters, 1, NULL);
+    if (result != NFD_OKAY)
+    {
+        if (result == NFD_ERROR)
+            std::cerr << "에러: " << NFD_GetError() << std::endl;
+        return;
+    }
+
+    std::string path = outPath;
+    NFD_FreePath(outPath);
+
+    std::string base_name = path;
+    size_t last_slash = base_name.find_last_of("/\\");
+    if (last_slash != std::string::npos)
+    {
+        base_name = base_name.substr(last_slash + 1);
+    }
+    size_t dot_pos = base_name.find_last_of('.');
+    if (dot_pos != std::string::npos)
+    {
+        base_name = base_name.substr(0, dot_pos);
+    }
+
+    float radius = epsilon;
+    int min_pts = min_points;
+    size_t budget_mb = tiled_budget_mb;
+    job.start("Tiled DBSCAN", [path, base_name, radius, min_pts, budget_mb]()
+              {
+                  auto start = std::chrono::high_resolution_clock::now();
+                  TiledDbscanStats stats;
+                  bool done = dbscan_clustering_tiled(path, "../model/" + base_name + "_labels.bin",
+                                                      "../model/" + base_name + "_dbscan_tiled.obj",
+                                                      radius, min_pts, budget_mb, &stats);
+                  auto end = std::chrono::high_resolution_clock::now();
+                  float seconds = std::chrono::duration<float>(end - start).count();
+
+                  return BackgroundJob::Apply([done, stats, seconds]()
+                                              {
+                                                  tiled_done = done;
+                                                  tiled_stats = stats;
+                                                  std::cout << "타일 DBSCAN 시간: " << seconds << " s" << std::endl;
+                                              });
+              });
+}
+
+void apply_floor_result(const FloorRemovalResult &floor_result, const std::vector<bool> &active, float seconds);
+
 void apply_floor_removal()
 {
     if (!dbscan_applied)
@@ -506,51 +1544,69 @@ void apply_floor_removal()
 
     std::cout << "\n=== 바닥 제거 시작 ===" << std::endl;
 
-    int before_count = dbscan_result_points.size();
-
-    auto start = std::chrono::high_resolution_clock::now();
-
-    // 수직 기둥 보호 방식으로 바닥 제거
-    FloorRemovalResult floor_result = remove_floor_with_column_protection(
-        dbscan_result_points,
-        floor_ratio,
-        search_radius,
-        mid_start,
-        mid_end,
-        min_points_above);
+    // 파라미터는 시작 시점 값으로 고정
+    float ratio = floor_ratio, radius = search_radius, start_ratio = mid_start, end_ratio = mid_end;
+    int min_above = min_points_above;
+    std::vector<bool> active = dbscan_mask;
+
+    job.start("Remove Floor", [=]()
+              {
+                  auto start = std::chrono::high_resolution_clock::now();
+
+                  // 수직 기둥 보호 방식으로 바닥 제거 (원본 트리를 DBSCAN 마스크로 필터링해서 재사용)
+                  FloorRemovalResult floor_result = remove_floor_with_column_protection(
+                      original_points,
+                      *tree,
+                      active,
+                      ratio,
+                      radius,
+                      start_ratio,
+                      end_ratio,
+                      min_above);
+
+                  auto end = std::chrono::high_resolution_clock::now();
+                  float seconds = std::chrono::duration<float>(end - start).count();
+
+                  return BackgroundJob::Apply([floor_result, active, seconds]()
+                                              { apply_floor_result(floor_result, active, seconds); });
+              });
+}
 
-    auto end = std::chrono::high_resolution_clock::now();
+// 바닥 제거 결과로 화면/상태 갱신 (주 스레드)
+void apply_floor_result(const FloorRemovalResult &floor_result, const std::vector<bool> &active, float seconds)
+{
+    int before_count = dbscan_result_points.size();
 
     // filtered_points 업데이트
     filtered_points = floor_result.filtered;
 
-    // ===== 빠른 인덱스 업데이트 (O(n)) =====
-    // 1. 제거된 인덱스를 set으로 변환 (O(n log n))
-    std::set<int> removed_set(floor_result.removed_indices.begin(),
-                              floor_result.removed_indices.end());
-
-    // 2. set으로 빠르게 체크 (O(log n) 검색)
-    std::vector<int> new_filtered_indices;
-    new_filtered_indices.reserve(filtered_indices.size()); // 메모리 미리 할당
+    // 인덱스 업데이트 (removed_indices는 원본 인덱스)
+    std::vector<bool> keep = active;
+    for (int idx : floor_result.removed_indices)
+    {
+        keep[idx] = false;
+    }
 
-    for (size_t i = 0; i < filtered_indices.size(); i++)
+    filtered_indices.clear();
+    for (size_t i = 0; i < keep.size(); i++)
     {
-        // O(log n) 검색
-        if (removed_set.find(i) == removed_set.end())
+        if (keep[i])
         {
-            new_filtered_indices.push_back(filtered_indices[i]);
+            filtered_indices.push_back(i);
         }
     }
-    filtered_indices = new_filtered_indices;
-    // ===== 끝 =====
 
     // 표시 업데이트
     total_points = before_count;
     removed_points = before_count - filtered_points.size();
-    last_execution_time = std::chrono::duration<float>(end - start).count();
+    last_execution_time = seconds;
 
     update_point_cloud_buffer(filtered_points);
 
+    // 바닥을 뺀 집합을 현재 마스크로 (이어지는 필터와 바닥 제거가 이 집합에서 시작)
+    dbscan_mask = keep;
+    dbscan_result_points = filtered_points;
+    result_suffix += "_floor";
     floor_removed = true;
     show_floor_vis = false;
 
@@ -589,8 +1645,20 @@ void visualize_floor()
     show_floor_vis = true;
 }
 
-int main()
+int main(int argc, char **argv)
 {
+    // 다중 프로세스 DBSCAN의 작업 프로세스로 실행된 경우 (창을 만들지 않음)
+    if (argc > 1 && std::string(argv[1]) == MULTIPROCESS_WORKER_ARG)
+    {
+        return run_multiprocess_dbscan_worker(argc, argv);
+    }
+
+    // 명령줄 벤치마크 (창을 만들지 않음)
+    if (argc > 1 && std::string(argv[1]) == BENCHMARK_ARG)
+    {
+        return run_benchmark(argc, argv);
+    }
+
     NFD_Init();
 
     // OBJ 파일 로드
@@ -623,10 +1691,9 @@ int main()
     total_points = original_points.size();
     std::cout << "총 " << total_points << "개 포인트 로드" << std::endl;
 
-    // KD-Tree 구축
-    std::cout << "KD-Tree 구축 중..." << std::endl;
-    tree = new KDTree(original_points);
-    std::cout << "KD-Tree 구축 완료!" << std::endl;
+    // KD-Tree (상위 레벨만 분할, 하위 트리는 처음 탐색할 때 구축)
+    tree = new KDTree(original_points, true);
+    std::cout << "KD-Tree 상위 레벨 분할 완료 (하위 트리는 필요할 때 구축)" << std::endl;
 
     // GLFW 초기화
     if (!glfwInit())
@@ -648,6 +1715,7 @@ int main()
     }
 
     glfwMakeContextCurrent(window);
+    glfwSwapInterval(1); // 백그라운드 작업 중에도 렌더 루프가 CPU를 다 쓰지 않도록 60 fps 동기화
     glfwSetMouseButtonCallback(window, mouse_button_callback);
     glfwSetCursorPosCallback(window, cursor_position_callback);
 
@@ -690,9 +1758,26 @@ int main()
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
 
+        // 끝난 백그라운드 작업 결과 적용
+        job.poll();
+
         // GUI 패널
         ImGui::Begin("DBSCAN Controls", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
 
+        // 작업 중에는 진행률 + 취소만 (다른 조작은 작업이 읽는 데이터를 바꿀 수 있어 비활성화)
+        if (job.running())
+        {
+            float fraction = job.progress();
+            ImGui::Text("%s...", job.name().c_str());
+            ImGui::ProgressBar(fraction >= 0.0f ? fraction : -1.0f * (float)ImGui::GetTime(), ImVec2(250, 0));
+            ImGui::SameLine();
+            if (ImGui::Button("Cancel"))
+            {
+                job.cancel();
+            }
+        }
+        ImGui::BeginDisabled(job.running());
+
         ImGui::Separator();
 
         if (ImGui::Button("Load OBJ"))
@@ -702,6 +1787,13 @@ int main()
 
         ImGui::SameLine();
 
+        if (ImGui::Button("Append OBJ"))
+        {
+            append_obj_dialog();
+        }
+
+        ImGui::SameLine();
+
         if (ImGui::Button("DBSCAN"))
         {
             apply_dbscan();
@@ -727,6 +1819,10 @@ int main()
         {
             save_result();
         }
+        if (saved_missing_normals > 0)
+        {
+            ImGui::Text("Saved: %d points without estimated normals (vn 0 0 0)", saved_missing_normals);
+        }
 
         ImGui::Separator();
 
@@ -740,6 +1836,12 @@ int main()
             ImGui::Text("Execution Time: %.2f s", last_execution_time);
         }
 
+        if (!job.running() && !neighbor_graph.empty())
+        {
+            ImGui::Text("Neighbor Graph: %.1f MB (Epsilon %.3f)",
+                        neighbor_graph.memory_bytes() / (1024.0f * 1024.0f), neighbor_graph.epsilon);
+        }
+
         ImGui::Separator();
 
         ImGui::PushItemWidth(250);
@@ -751,8 +1853,290 @@ int main()
         ImGui::PushItemWidth(220);
         ImGui::InputFloat("Epsilon (Radius)", &epsilon, 0.001f, 0.01f, "%.3f");
         ImGui::InputInt("MinPts", &min_points);
+
+        ImGui::InputFloat("Max Epsilon", &optics_max_epsilon, 0.001f, 0.01f, "%.3f");
+        ImGui::PopItemWidth();
+
+        if (ImGui::Button("Build OPTICS"))
+        {
+            build_optics();
+        }
+        if (optics_ready)
+        {
+            ImGui::SameLine();
+            ImGui::Text(optics_usable() ? "(Epsilon <= %.3f: instant)" : "(MinPts changed or Epsilon > %.3f)",
+                        optics.max_epsilon);
+
+            // OPTICS가 유효하면 슬라이더로 바로 재클러스터링
+            if (optics.min_points == min_points)
+            {
+                ImGui::PushItemWidth(220);
+                if (ImGui::SliderFloat("Epsilon (OPTICS)", &epsilon, 0.001f, optics.max_epsilon, "%.3f"))
+                {
+                    apply_dbscan();
+                }
+                ImGui::PopItemWidth();
+            }
+        }
+
+        ImGui::Text("Method:");
+        ImGui::SameLine();
+        ImGui::RadioButton("KD-Tree", &dbscan_method, 0);
+        ImGui::SameLine();
+        ImGui::RadioButton("Grid", &dbscan_method, 1);
+        ImGui::SameLine();
+        ImGui::RadioButton("Graph", &dbscan_method, 2);
+        ImGui::SameLine();
+        ImGui::RadioButton("Largest", &dbscan_method, 3);
+        ImGui::SameLine();
+        ImGui::RadioButton("Sampled", &dbscan_method, 4);
+        ImGui::SameLine();
+        ImGui::RadioButton("Incremental", &dbscan_method, 5);
+        ImGui::SameLine();
+        ImGui::RadioButton("Processes", &dbscan_method, 6);
+        ImGui::SameLine();
+        ImGui::RadioButton("Adaptive", &dbscan_method, 7);
+        if (dbscan_method == 7)
+        {
+            ImGui::PushItemWidth(220);
+            ImGui::SliderFloat("Scale", &adaptive_scale, 1.0f, 3.0f, "%.2f");
+            ImGui::PopItemWidth();
+            ImGui::Text(local_scales_k == min_points ? "(local distances cached, Epsilon = max radius)"
+                                                     : "(Epsilon = max radius)");
+        }
+        if (dbscan_method == 6)
+        {
+            ImGui::PushItemWidth(220);
+            ImGui::SliderInt("Worker Processes", &process_workers, 1, 16);
+            ImGui::PopItemWidth();
+            if (!job.running() && process_stats.workers > 0)
+            {
+                ImGui::Text("Partition %.2f s, Core %.2f s, Merge %.2f s, Border %.2f s",
+                            process_stats.partition_time, process_stats.core_time,
+                            process_stats.merge_time, process_stats.border_time);
+            }
+        }
+        if (dbscan_method == 4)
+        {
+            ImGui::PushItemWidth(220);
+            ImGui::InputFloat("Voxel Size", &sample_voxel_size, 0.001f, 0.01f, "%.3f");
+            ImGui::PopItemWidth();
+
+            // 현재 파라미터로 근사 DBSCAN을 돌려 기준 블록의 정확 DBSCAN과 비교
+            if (ImGui::Button("Quality Report"))
+            {
+                tree->build_all();
+                std::vector<int> labels = dbscan_clustering_sampled(original_points, *tree, epsilon, min_points,
+                                                                    sample_voxel_size);
+                sample_quality = evaluate_sampled_dbscan(original_points, *tree, labels, epsilon, min_points);
+                sample_quality_ready = true;
+            }
+            if (sample_quality_ready)
+            {
+                ImGui::Text("Agreement: noise %.1f%%, label %.1f%% (%d pts)",
+                            sample_quality.noise_agreement * 100.0f, sample_quality.label_agreement * 100.0f,
+                            sample_quality.reference_points);
+            }
+        }
+        if (dbscan_method == 2)
+        {
+            ImGui::PushItemWidth(220);
+            ImGui::InputInt("Graph Budget (MB)", &graph_budget_mb, 64, 256);
+            ImGui::PopItemWidth();
+        }
+
+        // DBSCAN 입력 (빠른 파라미터 조정용 복셀 점, FPS/Poisson 샘플, 또는 필터로 줄인 현재 결과)
+        ImGui::Text("Input:");
+        ImGui::SameLine();
+        ImGui::RadioButton("All Points", &dbscan_input, 0);
+        ImGui::SameLine();
+        ImGui::RadioButton("Voxels", &dbscan_input, 1);
+        ImGui::SameLine();
+        ImGui::RadioButton("Sample", &dbscan_input, 2);
+        ImGui::SameLine();
+        ImGui::RadioButton("Current", &dbscan_input, 3);
+        if (dbscan_input == 2 && uniform_sample.empty())
+        {
+            ImGui::Text("(run Farthest Point or Poisson Disk first, all points used)");
+        }
+        if (dbscan_input == 3 && !dbscan_applied)
+        {
+            ImGui::Text("(no result yet, all points used)");
+        }
+        if (dbscan_input != 0 && (dbscan_method == 2 || dbscan_method == 5 || dbscan_method == 7))
+        {
+            ImGui::Text("(Graph/Incremental/Adaptive use all points)");
+        }
+        if (dbscan_input == 1)
+        {
+            ImGui::SameLine();
+            ImGui::Checkbox("Nearest Point", &downsample_nearest);
+            ImGui::PushItemWidth(220);
+            ImGui::InputFloat("Downsample Voxel", &downsample_voxel_size, 0.001f, 0.01f, "%.3f");
+            ImGui::PopItemWidth();
+            downsample_voxel_size = std::max(downsample_voxel_size, 0.0001f);
+            if (!job.running() && !voxel_subsample.empty())
+            {
+                ImGui::Text("Voxels: %d / %d", (int)voxel_subsample.points.size(), (int)original_points.size());
+            }
+        }
+
+        ImGui::PushItemWidth(220);
+        ImGui::InputInt("Memory Budget (MB)", &tiled_budget_mb, 64, 256);
         ImGui::PopItemWidth();
+        tiled_budget_mb = std::max(tiled_budget_mb, 16);
+        if (ImGui::Button("Tiled DBSCAN (File)"))
+        {
+            tiled_dbscan_file();
+        }
+        if (tiled_done)
+        {
+            ImGui::Text("Tiles: %d, Clusters: %d, Largest: %lld / %lld",
+                        tiled_stats.tile_count, tiled_stats.cluster_count,
+                        tiled_stats.largest_cluster, tiled_stats.point_count);
+        }
 
+        if (ImGui::Button("Epsilon Curve"))
+        {
+            compute_epsilon_curve();
+        }
+        if (!epsilon_curve.empty())
+        {
+            ImGui::PlotLines("Core Ratio", epsilon_curve.data(), epsilon_curve.size(),
+                             0, nullptr, 0.0f, 1.0f, ImVec2(220, 60));
+            ImGui::Text("Epsilon: %.3f ~ %.3f", epsilon_curve_radii.front(), epsilon_curve_radii.back());
+        }
+
+        // MinPts번째 이웃 거리 곡선의 무릎 -> Epsilon 추천
+        ImGui::PushItemWidth(220);
+        ImGui::InputFloat("Sample (%)", &k_distance_sample_percent, 1.0f, 10.0f, "%.1f");
+        ImGui::PopItemWidth();
+        k_distance_sample_percent = std::min(std::max(k_distance_sample_percent, 0.01f), 100.0f);
+        if (ImGui::Button("K-Distance"))
+        {
+            compute_k_distance();
+        }
+        if (!k_distance_plot.empty())
+        {
+            // 이상치 꼬리가 곡선을 눌러 보이지 않게 추천값의 3배까지만 표시
+            ImGui::PlotLines("K-Distance", k_distance_plot.data(), k_distance_plot.size(),
+                             0, nullptr, 0.0f, k_distance.suggested_epsilon * 3.0f, ImVec2(220, 60));
+            ImGui::Text("k = %d, knee at %.1f%%: Epsilon %.4f", k_distance.k,
+                        100.0f * k_distance.knee_index / std::max((int)k_distance.distances.size() - 1, 1),
+                        k_distance.suggested_epsilon);
+            ImGui::SameLine();
+            if (ImGui::Button("Use"))
+            {
+                epsilon = k_distance.suggested_epsilon;
+            }
+        }
+
+        ImGui::Separator();
+
+        // 이상점 필터 (현재 결과에 적용)
+        ImGui::Text("Outlier Filter:");
+        ImGui::PushItemWidth(220);
+        ImGui::InputInt("SOR K", &sor_k);
+        sor_k = std::max(sor_k, 1);
+        ImGui::SliderFloat("SOR Std Ratio", &sor_std_ratio, 0.0f, 5.0f, "%.2f");
+        ImGui::PopItemWidth();
+        if (ImGui::Button("Statistical Filter"))
+        {
+            apply_statistical_filter();
+        }
+        if (!job.running() && sor_stats.checked > 0)
+        {
+            ImGui::Text("Mean %.4f, Std %.4f, Threshold %.4f, Removed %d / %d",
+                        sor_stats.mean_distance, sor_stats.stddev, sor_stats.threshold,
+                        sor_stats.removed, sor_stats.checked);
+        }
+
+        ImGui::PushItemWidth(220);
+        ImGui::SliderFloat("ROR Radius", &ror_radius, 0.001f, 0.1f, "%.3f");
+        ImGui::InputInt("ROR Min Neighbors", &ror_min_neighbors);
+        ror_min_neighbors = std::max(ror_min_neighbors, 1);
+        ImGui::PopItemWidth();
+        if (ImGui::Button("Radius Filter"))
+        {
+            apply_radius_filter();
+        }
+        if (!job.running() && ror_stats.checked > 0)
+        {
+            ImGui::Text("Removed %d / %d", ror_stats.removed, ror_stats.checked);
+        }
+
+        // LOF (점수 색 표시 후 기준 이상 제거)
+        ImGui::PushItemWidth(220);
+        ImGui::InputInt("LOF K", &lof_k);
+        lof_k = std::max(lof_k, 1);
+        ImGui::PopItemWidth();
+        if (ImGui::Button("Compute LOF"))
+        {
+            compute_lof();
+        }
+        if (!job.running() && !lof_scores.empty())
+        {
+            ImGui::SameLine();
+            ImGui::Checkbox("Show LOF", &show_lof);
+            ImGui::PushItemWidth(220);
+            if (ImGui::SliderFloat("LOF Threshold", &lof_threshold, 1.0f, 5.0f, "%.2f"))
+            {
+                count_lof_above();
+            }
+            ImGui::PopItemWidth();
+            ImGui::Text("Above threshold: %d / %d (graph k = %d)", lof_above, lof_vis_count, lof_graph.k);
+            if (ImGui::Button("Remove LOF Outliers"))
+            {
+                remove_lof_outliers();
+            }
+        }
+        ImGui::Separator();
+
+        // 법선/곡률 (저장 시 메시에 법선이 없으면 함께 기록)
+        ImGui::Text("Normals:");
+        ImGui::PushItemWidth(220);
+        ImGui::InputInt("Normal K", &normal_k);
+        normal_k = std::max(normal_k, 3);
+        ImGui::PopItemWidth();
+        if (ImGui::Button("Estimate Normals"))
+        {
+            compute_normals();
+        }
+        if (!job.running() && normal_count > 0)
+        {
+            ImGui::Text("Normals: %d points, mean curvature %.4f", normal_count, mean_curvature);
+            ImGui::PushItemWidth(220);
+            ImGui::SliderFloat("Max Curvature", &max_curvature, 0.0f, 0.34f, "%.3f");
+            ImGui::PopItemWidth();
+            if (ImGui::Button("Curvature Filter"))
+            {
+                apply_curvature_filter();
+            }
+        }
+        ImGui::Separator();
+
+        // 균일 샘플링 (결과를 미리보기로 표시, 바닥 제거 입력 또는 DBSCAN Input = Sample로 사용)
+        ImGui::Text("Subsampling:");
+        ImGui::PushItemWidth(220);
+        ImGui::InputInt("FPS Count", &fps_count, 1000, 10000);
+        fps_count = std::max(fps_count, 1);
+        ImGui::PopItemWidth();
+        if (ImGui::Button("Farthest Point"))
+        {
+            apply_farthest_point_sample();
+        }
+        ImGui::PushItemWidth(220);
+        ImGui::InputFloat("Poisson Spacing", &poisson_spacing, 0.001f, 0.01f, "%.3f");
+        poisson_spacing = std::max(poisson_spacing, 0.0001f);
+        ImGui::PopItemWidth();
+        if (ImGui::Button("Poisson Disk"))
+        {
+            apply_poisson_disk_sample();
+        }
+        if (!job.running() && !uniform_sample.empty())
+        {
+            ImGui::Text("Sample: %d / %d", (int)uniform_sample.points.size(), (int)original_points.size());
+        }
         ImGui::Separator();
 
         ImGui::PushItemWidth(250);
@@ -781,6 +2165,17 @@ int main()
         ImGui::SliderFloat("Mid End", &mid_end, 0.20f, 0.60f, "%.2f");
         ImGui::SliderInt("Min Points", &min_points_above, 5, 500);
 
+        if (ImGui::Button("Radius Curve"))
+        {
+            compute_floor_curve();
+        }
+        if (!floor_curve.empty())
+        {
+            ImGui::PlotLines("Floor Removed", floor_curve.data(), floor_curve.size(),
+                             0, nullptr, 0.0f, 1.0f, ImVec2(220, 60));
+            ImGui::Text("Search Radius: %.2f ~ %.2f", floor_curve_radii.front(), floor_curve_radii.back());
+        }
+
         ImGui::Separator();
 
         ImGui::Text("Controls (Right-click required):");
@@ -788,6 +2183,7 @@ int main()
         ImGui::BulletText("W/A/S/D: Move");
         ImGui::BulletText("Q/E: Up/Down");
 
+        ImGui::EndDisabled();
         ImGui::End();
 
         // 렌더링
@@ -801,8 +2197,12 @@ int main()
         glfwSwapBuffers(window);
     }
 
-    // 정리
+    // 정리 (실행 중인 작업은 취소하고 끝날 때까지 대기)
+    job.stop();
     delete tree;
+    delete voxel_tree;
+    delete uniform_sample_tree;
+    delete incremental;
     free_mesh(mesh);
 
     glDeleteVertexArrays(1, &vao);
@@ -814,6 +2214,11 @@ int main()
         glDeleteVertexArrays(1, &floor_vao);
         glDeleteBuffers(1, &floor_vbo);
     }
+    if (lof_vao != 0)
+    {
+        glDeleteVertexArrays(1, &lof_vao);
+        glDeleteBuffers(1, &lof_vbo);
+    }
 
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
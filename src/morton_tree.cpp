@@ -0,0 +1,410 @@
+#include "morton_tree.h"
+#include "parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+
+// ==================== Morton 코드 ====================
+
+// 21비트 값을 3칸 간격으로 펼침 (x -> x00x00x...)
+static uint64_t expand_bits(uint64_t v)
+{
+    v &= 0x1fffff;
+    v = (v | v << 32) & 0x1f00000000ffffULL;
+    v = (v | v << 16) & 0x1f0000ff0000ffULL;
+    v = (v | v << 8) & 0x100f00f00f00f00fULL;
+    v = (v | v << 4) & 0x10c30c30c30c30c3ULL;
+    v = (v | v << 2) & 0x1249249249249249ULL;
+    return v;
+}
+
+static int leading_zeros(uint64_t v)
+{
+#if defined(__GNUC__)
+    return v == 0 ? 64 : __builtin_clzll(v);
+#else
+    int n = 0;
+    for (uint64_t bit = 1ULL << 63; bit && !(v & bit); bit >>= 1)
+        n++;
+    return n;
+#endif
+}
+
+// ==================== 병렬 radix 정렬 ====================
+
+// 64비트 키 LSD radix 정렬 (8비트씩, 블록별 히스토그램 -> 병렬 분배, 안정 정렬)
+static void radix_sort(std::vector<uint64_t> &keys, std::vector<int> &values)
+{
+    const int block_size = 65536;
+    int n = keys.size();
+    int block_count = (n + block_size - 1) / block_size;
+
+    std::vector<uint64_t> tmp_keys(n);
+    std::vector<int> tmp_values(n);
+    std::vector<int> offsets((size_t)block_count * 256);
+
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        // 1. 블록별 히스토그램
+        std::fill(offsets.begin(), offsets.end(), 0);
+        parallel_for(0, block_count, 1, [&](int begin, int end, int)
+                     {
+                         for (int b = begin; b < end; b++)
+                         {
+                             int *hist = &offsets[(size_t)b * 256];
+                             int last = std::min(n, (b + 1) * block_size);
+                             for (int i = b * block_size; i < last; i++)
+                             {
+                                 hist[(keys[i] >> shift) & 0xff]++;
+                             }
+                         }
+                     });
+
+        // 모든 키가 같은 digit이면 이 자리는 건너뜀
+        bool skip = false;
+        for (int d = 0; d < 256 && !skip; d++)
+        {
+            int total = 0;
+            for (int b = 0; b < block_count; b++)
+            {
+                total += offsets[(size_t)b * 256 + d];
+            }
+            skip = total == n;
+        }
+        if (skip)
+            continue;
+
+        // 2. digit 우선, 블록 순서로 시작 위치 계산
+        int sum = 0;
+        for (int d = 0; d < 256; d++)
+        {
+            for (int b = 0; b < block_count; b++)
+            {
+                int &slot = offsets[(size_t)b * 256 + d];
+                int count = slot;
+                slot = sum;
+                sum += count;
+            }
+        }
+
+        // 3. 블록별로 병렬 분배
+        parallel_for(0, block_count, 1, [&](int begin, int end, int)
+                     {
+                         for (int b = begin; b < end; b++)
+                         {
+                             int *pos = &offsets[(size_t)b * 256];
+                             int last = std::min(n, (b + 1) * block_size);
+                             for (int i = b * block_size; i < last; i++)
+                             {
+                                 int dst = pos[(keys[i] >> shift) & 0xff]++;
+                                 tmp_keys[dst] = keys[i];
+                                 tmp_values[dst] = values[i];
+                             }
+                         }
+                     });
+
+        keys.swap(tmp_keys);
+        values.swap(tmp_values);
+    }
+}
+
+// ==================== 생성자 ====================
+
+MortonTree::MortonTree(const std::vector<Point3D> &pts)
+{
+    int n = pts.size();
+    if (n == 0)
+        return;
+
+    // 1. 전체 범위 (스레드별 최소/최대)
+    int threads = worker_count();
+    std::vector<Point3D> local_min(threads, pts[0]);
+    std::vector<Point3D> local_max(threads, pts[0]);
+
+    parallel_for(0, n, 65536, [&](int begin, int end, int thread_id)
+                 {
+                     Point3D &lo = local_min[thread_id];
+                     Point3D &hi = local_max[thread_id];
+                     for (int i = begin; i < end; i++)
+                     {
+                         lo.x = std::min(lo.x, pts[i].x);
+                         lo.y = std::min(lo.y, pts[i].y);
+                         lo.z = std::min(lo.z, pts[i].z);
+                         hi.x = std::max(hi.x, pts[i].x);
+                         hi.y = std::max(hi.y, pts[i].y);
+                         hi.z = std::max(hi.z, pts[i].z);
+                     }
+                 });
+
+    Point3D lo = local_min[0], hi = local_max[0];
+    for (int t = 1; t < threads; t++)
+    {
+        lo.x = std::min(lo.x, local_min[t].x);
+        lo.y = std::min(lo.y, local_min[t].y);
+        lo.z = std::min(lo.z, local_min[t].z);
+        hi.x = std::max(hi.x, local_max[t].x);
+        hi.y = std::max(hi.y, local_max[t].y);
+        hi.z = std::max(hi.z, local_max[t].z);
+    }
+
+    // 2. 63비트 Morton 코드 (축마다 21비트, 정육면체 격자로 양자화)
+    float extent = std::max(hi.x - lo.x, std::max(hi.y - lo.y, hi.z - lo.z));
+    const uint64_t max_cell = (1 << 21) - 1;
+    float scale = extent > 0 ? (float)max_cell / extent : 0.0f;
+
+    std::vector<uint64_t> codes(n);
+    order.resize(n);
+
+    parallel_for(0, n, 65536, [&](int begin, int end, int)
+                 {
+                     for (int i = begin; i < end; i++)
+                     {
+                         uint64_t qx = std::min((uint64_t)((pts[i].x - lo.x) * scale), max_cell);
+                         uint64_t qy = std::min((uint64_t)((pts[i].y - lo.y) * scale), max_cell);
+                         uint64_t qz = std::min((uint64_t)((pts[i].z - lo.z) * scale), max_cell);
+                         codes[i] = expand_bits(qx) << 2 | expand_bits(qy) << 1 | expand_bits(qz);
+                         order[i] = i;
+                     }
+                 });
+
+    // 3. 코드 정렬
+    radix_sort(codes, order);
+
+    // 4. 정렬된 순서로 점 배치 (리프 탐색이 연속 메모리 접근이 되도록)
+    xs.resize(n);
+    ys.resize(n);
+    zs.resize(n);
+    parallel_for(0, n, 65536, [&](int begin, int end, int)
+                 {
+                     for (int i = begin; i < end; i++)
+                     {
+                         const Point3D &p = pts[order[i]];
+                         xs[i] = p.x;
+                         ys[i] = p.y;
+                         zs[i] = p.z;
+                     }
+                 });
+
+    // 5. 연속된 MORTON_LEAF_SIZE개씩 리프로 묶고 계층 구축
+    int leaf_count = (n + MORTON_LEAF_SIZE - 1) / MORTON_LEAF_SIZE;
+    std::vector<uint64_t> leaf_codes(leaf_count);
+    leaves.resize(leaf_count);
+    for (int b = 0; b < leaf_count; b++)
+    {
+        leaf_codes[b] = codes[(size_t)b * MORTON_LEAF_SIZE];
+        leaves[b].left = b * MORTON_LEAF_SIZE;
+        leaves[b].right = std::min(n, (b + 1) * MORTON_LEAF_SIZE);
+    }
+
+    build_hierarchy(leaf_codes);
+    build_bounds();
+}
+
+// ==================== 계층 구축 ====================
+
+void MortonTree::build_hierarchy(const std::vector<uint64_t> &leaf_codes)
+{
+    int m = leaf_codes.size();
+    nodes.assign(m - 1, MortonNode());
+
+    // i, j 코드의 공통 접두사 길이 (코드가 같으면 인덱스로 구분)
+    auto delta = [&leaf_codes, m](int i, int j) -> int
+    {
+        if (j < 0 || j >= m)
+            return -1;
+        uint64_t a = leaf_codes[i], b = leaf_codes[j];
+        if (a == b)
+            return 64 + leading_zeros((uint64_t)(uint32_t)(i ^ j)) - 32;
+        return leading_zeros(a ^ b);
+    };
+
+    // 내부 노드마다 독립적으로 구간과 분할 위치 계산
+    parallel_for(0, m - 1, 4096, [&](int begin, int end, int)
+                 {
+                     for (int i = begin; i < end; i++)
+                     {
+                         // 구간 방향
+                         int d = delta(i, i + 1) - delta(i, i - 1) > 0 ? 1 : -1;
+                         int delta_min = delta(i, i - d);
+
+                         // 구간 다른 끝 찾기
+                         int l_max = 2;
+                         while (delta(i, i + l_max * d) > delta_min)
+                             l_max *= 2;
+
+                         int l = 0;
+                         for (int t = l_max / 2; t >= 1; t /= 2)
+                         {
+                             if (delta(i, i + (l + t) * d) > delta_min)
+                                 l += t;
+                         }
+                         int j = i + l * d;
+
+                         // 분할 위치 (공통 접두사가 끊기는 곳)
+                         int delta_node = delta(i, j);
+                         int s = 0;
+                         int t = l;
+                         do
+                         {
+                             t = (t + 1) / 2;
+                             if (delta(i, i + (s + t) * d) > delta_node)
+                                 s += t;
+                         } while (t > 1);
+                         int split = i + s * d + std::min(d, 0);
+
+                         MortonNode &node = nodes[i];
+                         node.left = std::min(i, j) == split ? ~split : split;
+                         node.right = std::max(i, j) == split + 1 ? ~(split + 1) : split + 1;
+                     }
+                 });
+}
+
+// 두 AABB 합치기
+static void merge_bounds(MortonNode &dst, const MortonNode &a, const MortonNode &b)
+{
+    dst.min_x = std::min(a.min_x, b.min_x);
+    dst.min_y = std::min(a.min_y, b.min_y);
+    dst.min_z = std::min(a.min_z, b.min_z);
+    dst.max_x = std::max(a.max_x, b.max_x);
+    dst.max_y = std::max(a.max_y, b.max_y);
+    dst.max_z = std::max(a.max_z, b.max_z);
+}
+
+void MortonTree::build_bounds()
+{
+    int leaf_count = leaves.size();
+    int internal_count = nodes.size();
+
+    // 1. 리프 AABB
+    parallel_for(0, leaf_count, 4096, [&](int begin, int end, int)
+                 {
+                     for (int b = begin; b < end; b++)
+                     {
+                         MortonNode &leaf = leaves[b];
+                         leaf.min_x = leaf.max_x = xs[leaf.left];
+                         leaf.min_y = leaf.max_y = ys[leaf.left];
+                         leaf.min_z = leaf.max_z = zs[leaf.left];
+                         for (int i = leaf.left + 1; i < leaf.right; i++)
+                         {
+                             leaf.min_x = std::min(leaf.min_x, xs[i]);
+                             leaf.min_y = std::min(leaf.min_y, ys[i]);
+                             leaf.min_z = std::min(leaf.min_z, zs[i]);
+                             leaf.max_x = std::max(leaf.max_x, xs[i]);
+                             leaf.max_y = std::max(leaf.max_y, ys[i]);
+                             leaf.max_z = std::max(leaf.max_z, zs[i]);
+                         }
+                     }
+                 });
+
+    if (internal_count == 0)
+        return;
+
+    // 2. 부모 연결
+    std::vector<int> leaf_parent(leaf_count, -1);
+    std::vector<int> node_parent(internal_count, -1);
+    for (int i = 0; i < internal_count; i++)
+    {
+        for (int child : {nodes[i].left, nodes[i].right})
+        {
+            if (child < 0)
+                leaf_parent[~child] = i;
+            else
+                node_parent[child] = i;
+        }
+    }
+
+    // 3. 리프에서 위로 올라가며 두 번째로 도착한 스레드가 부모 AABB 계산
+    std::unique_ptr<std::atomic<int>[]> visits(new std::atomic<int>[internal_count]);
+    for (int i = 0; i < internal_count; i++)
+    {
+        visits[i].store(0, std::memory_order_relaxed);
+    }
+
+    parallel_for(0, leaf_count, 4096, [&](int begin, int end, int)
+                 {
+                     for (int b = begin; b < end; b++)
+                     {
+                         int p = leaf_parent[b];
+                         while (p != -1)
+                         {
+                             if (visits[p].fetch_add(1, std::memory_order_acq_rel) == 0)
+                                 break; // 다른 자식이 아직 계산 중
+
+                             MortonNode &node = nodes[p];
+                             const MortonNode &l = node.left < 0 ? leaves[~node.left] : nodes[node.left];
+                             const MortonNode &r = node.right < 0 ? leaves[~node.right] : nodes[node.right];
+                             merge_bounds(node, l, r);
+                             p = node_parent[p];
+                         }
+                     }
+                 });
+}
+
+// ==================== 반경 탐색 ====================
+
+// 점과 AABB 사이 최소 거리가 반경 이내인지 (점 거리 계산과 같은 연산 순서)
+static bool box_in_range(const MortonNode &b, const Point3D &target, float radius)
+{
+    float dx = std::max(std::max(b.min_x - target.x, 0.0f), target.x - b.max_x);
+    float dy = std::max(std::max(b.min_y - target.y, 0.0f), target.y - b.max_y);
+    float dz = std::max(std::max(b.min_z - target.z, 0.0f), target.z - b.max_z);
+    return std::sqrt(dx * dx + dy * dy + dz * dz) <= radius;
+}
+
+void MortonTree::search_leaf(int leaf, const Point3D &target, float radius,
+                             std::vector<int> &neighbors)
+{
+    const MortonNode &node = leaves[leaf];
+    for (int i = node.left; i < node.right; i++)
+    {
+        float dx = xs[i] - target.x;
+        float dy = ys[i] - target.y;
+        float dz = zs[i] - target.z;
+        if (std::sqrt(dx * dx + dy * dy + dz * dz) <= radius)
+        {
+            neighbors.push_back(order[i]);
+        }
+    }
+}
+
+std::vector<int> MortonTree::find_radius(const Point3D &target, float radius)
+{
+    std::vector<int> neighbors;
+
+    if (leaves.empty())
+        return neighbors;
+
+    if (nodes.empty())
+    {
+        search_leaf(0, target, radius, neighbors);
+        return neighbors;
+    }
+
+    // 트리 깊이는 키 비트 수(64) + 인덱스 비트 수(32)를 넘지 않음
+    int stack[128];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        const MortonNode &node = nodes[stack[--top]];
+        if (!box_in_range(node, target, radius))
+            continue;
+
+        for (int child : {node.right, node.left})
+        {
+            if (child < 0)
+            {
+                if (box_in_range(leaves[~child], target, radius))
+                    search_leaf(~child, target, radius, neighbors);
+            }
+            else
+            {
+                stack[top++] = child;
+            }
+        }
+    }
+
+    return neighbors;
+}
@@ -0,0 +1,49 @@
+#ifndef MORTON_TREE_H
+#define MORTON_TREE_H
+
+#include <cstdint>
+#include <vector>
+#include "point3d.h"
+
+// 리프 하나에 들어가는 최대 점 수 (Morton 순서로 연속된 점들)
+const int MORTON_LEAF_SIZE = 16;
+
+// Morton 트리 노드 (AABB + 자식)
+struct MortonNode
+{
+    float min_x, min_y, min_z;
+    float max_x, max_y, max_z;
+    int left, right; // 자식 번호 (0 이상: 내부 노드, 음수: ~리프 번호)
+};
+
+// Morton 코드 기반 선형 BVH (LBVH)
+// 63비트 Morton 코드를 병렬로 계산해 radix 정렬한 뒤, 정렬된 코드에서 계층을 바로 유도
+// 중앙값 선택이 없어서 O(n)이고 모든 단계가 병렬 -> 아주 큰 점군용
+// find_radius 결과는 KDTree::find_radius와 같은 집합 (순서는 다를 수 있음)
+class MortonTree
+{
+private:
+    // Morton 순서로 정렬된 점 (SoA) + 원본 인덱스
+    std::vector<float> xs, ys, zs;
+    std::vector<int> order;
+
+    std::vector<MortonNode> nodes; // 내부 노드, 0번이 루트 (리프가 하나면 비어 있음)
+    std::vector<MortonNode> leaves; // 리프 AABB, left/right = 정렬된 점 구간 [left, right)
+
+    // 정렬된 코드에서 내부 노드 계층 구축 (Karras 2012)
+    void build_hierarchy(const std::vector<uint64_t> &leaf_codes);
+
+    // 아래에서 위로 AABB 계산
+    void build_bounds();
+
+    void search_leaf(int leaf, const Point3D &target, float radius,
+                     std::vector<int> &neighbors);
+
+public:
+    MortonTree(const std::vector<Point3D> &pts);
+
+    std::vector<int> find_radius(const Point3D &target, float radius);
+
+};
+
+#endif // MORTON_TREE_H
@@ -0,0 +1,674 @@
+#include "multiprocess_dbscan.h"
+#include "clustering.h"
+#include "kdtree.h"
+#include "parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <climits>
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
+#endif
+
+namespace
+{
+    // 공유 메모리 앞부분 (뒤에 Point3D points[n], int root[n], int label[n])
+    struct SharedHeader
+    {
+        int n;
+        int workers;
+        float radius;
+        int min_points;
+        int threads; // 작업 프로세스별 스레드 수 (코어 수 / 프로세스 수)
+        int range[MULTIPROCESS_MAX_WORKERS + 1];  // 작업 프로세스 w의 구간 = 정렬 위치 [range[w], range[w+1])
+        int halo_begin[MULTIPROCESS_MAX_WORKERS]; // 구간 + 앞뒤 radius 폭 = [halo_begin[w], halo_end[w])
+        int halo_end[MULTIPROCESS_MAX_WORKERS];
+        float core_time[MULTIPROCESS_MAX_WORKERS];
+        float border_time[MULTIPROCESS_MAX_WORKERS];
+
+        std::atomic<int> phase;                              // 1: 코어, 2: 경계점, -1: 중단
+        std::atomic<int> progress[MULTIPROCESS_MAX_WORKERS]; // 작업 프로세스별 끝낸 단계 수
+    };
+
+    size_t header_bytes()
+    {
+        return (sizeof(SharedHeader) + 63) / 64 * 64;
+    }
+
+    size_t shared_bytes(int n)
+    {
+        return header_bytes() + (size_t)n * (sizeof(Point3D) + 2 * sizeof(int));
+    }
+
+    Point3D *shared_points(SharedHeader *header)
+    {
+        return (Point3D *)((char *)header + header_bytes());
+    }
+
+    // 코어: 최종 단계 전까지 구간 안 루트 (정렬 위치), 조정자 병합 후 클러스터 번호, 코어가 아니면 -1
+    int *shared_root(SharedHeader *header)
+    {
+        return (int *)(shared_points(header) + header->n);
+    }
+
+    int *shared_label(SharedHeader *header)
+    {
+        return shared_root(header) + header->n;
+    }
+
+    int find_root(std::vector<int> &parent, int i)
+    {
+        while (parent[i] != i)
+        {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    }
+
+    void unite(std::vector<int> &parent, int a, int b)
+    {
+        a = find_root(parent, a);
+        b = find_root(parent, b);
+        if (a < b)
+            parent[b] = a;
+        else if (b < a)
+            parent[a] = b;
+    }
+
+    // queries(트리 로컬 번호, 공간 순서)를 패킷으로 묶어 func(쿼리, 이웃 목록) 호출
+    template <typename Func>
+    void for_each_neighbors(KDTree &tree, const std::vector<Point3D> &local, const std::vector<int> &queries,
+                            float radius, Func func)
+    {
+        Point3D targets[KDTREE_PACKET_SIZE];
+        std::vector<int> neighbors[KDTREE_PACKET_SIZE];
+        for (size_t start = 0; start < queries.size(); start += KDTREE_PACKET_SIZE)
+        {
+            int count = std::min(queries.size() - start, (size_t)KDTREE_PACKET_SIZE);
+            for (int q = 0; q < count; q++)
+            {
+                targets[q] = local[queries[start + q]];
+                neighbors[q].clear();
+            }
+
+            tree.find_radius_packet(targets, count, radius, neighbors);
+
+            for (int q = 0; q < count; q++)
+            {
+                func(queries[start + q], neighbors[q]);
+            }
+        }
+    }
+
+    // 작업 프로세스 본체
+    int worker_main(SharedHeader *header, int w)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        // 프로세스마다 모든 코어를 쓰면 프로세스 수만큼 과구독되므로 나눠 받은 만큼만 사용
+        worker_limit.store(header->threads);
+
+        Point3D *points = shared_points(header);
+        int *root = shared_root(header);
+        int *label = shared_label(header);
+        float radius = header->radius;
+        int lo = header->halo_begin[w];
+        int own_begin = header->range[w] - lo; // 트리 로컬 번호 기준
+        int own_end = header->range[w + 1] - lo;
+
+        std::vector<Point3D> local(points + lo, points + header->halo_end[w]);
+        KDTree tree(local, true);
+        tree.build_all();
+
+        // 1. halo 포함 범위의 격자 DBSCAN (자기 구간 점은 이웃이 모두 트리에 있어 코어 판정이 정확)
+        //    halo 점은 이웃이 잘려 코어가 덜 나올 뿐이므로 같은 레이블의 코어는 전역으로도 연결됨
+        //    (halo를 거쳐야만 이어지는 연결은 조정자의 구간 경계 병합에서 복구)
+        std::vector<char> core;
+        std::vector<int> local_labels = dbscan_clustering_grid(local, tree, radius, header->min_points, &core);
+
+        std::vector<int> owned; // 자기 구간 점 (트리 순서라 패킷이 공간적으로 모임)
+        for (int i : tree.spatial_order())
+        {
+            if (i >= own_begin && i < own_end)
+                owned.push_back(i);
+        }
+
+        // 2. 구간 안 루트 = 같은 로컬 클러스터의 첫 코어
+        std::vector<int> first_core; // 로컬 클러스터 -> 자기 구간의 첫 코어 (정렬 위치)
+        for (int i = own_begin; i < own_end; i++)
+        {
+            int id = local_labels[i];
+            if (!core[i])
+            {
+                root[lo + i] = -1;
+                continue;
+            }
+
+            if (id >= (int)first_core.size())
+                first_core.resize(id + 1, -1);
+            if (first_core[id] == -1)
+                first_core[id] = lo + i;
+            root[lo + i] = first_core[id];
+        }
+
+        auto core_end = std::chrono::high_resolution_clock::now();
+        header->core_time[w] = std::chrono::duration<float>(core_end - start).count();
+        header->progress[w].fetch_add(1);
+
+        // 3. 조정자가 클러스터 번호를 쓸 때까지 대기
+        for (;;)
+        {
+            int phase = header->phase.load();
+            if (phase == -1)
+                return 1;
+            if (phase == 2)
+                break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        auto border_start = std::chrono::high_resolution_clock::now();
+
+        // 4. 경계점: 이웃 코어 중 가장 작은 클러스터 번호 (halo 코어 번호도 조정자가 채워 둠)
+        std::vector<int> border;
+        for (int i : owned)
+        {
+            if (core[i])
+                label[lo + i] = root[lo + i];
+            else
+                border.push_back(i);
+        }
+        for_each_neighbors(tree, local, border, radius, [&](int i, const std::vector<int> &neighbors)
+                           {
+                               int best = -1;
+                               for (int j : neighbors)
+                               {
+                                   int id = root[lo + j];
+                                   if (id >= 0 && (best == -1 || id < best))
+                                       best = id;
+                               }
+                               label[lo + i] = best;
+                           });
+
+        auto border_end = std::chrono::high_resolution_clock::now();
+        header->border_time[w] = std::chrono::duration<float>(border_end - border_start).count();
+        header->progress[w].fetch_add(1);
+        return 0;
+    }
+
+    // ========== 플랫폼별 공유 메모리 / 프로세스 ==========
+#ifdef _WIN32
+    struct SharedRegion
+    {
+        HANDLE mapping = NULL;
+        void *data = nullptr;
+    };
+
+    bool create_region(SharedRegion &region, const std::string &name, size_t size)
+    {
+        region.mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+                                            (DWORD)((unsigned long long)size >> 32), (DWORD)size, name.c_str());
+        if (!region.mapping)
+            return false;
+        region.data = MapViewOfFile(region.mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+        return region.data != nullptr;
+    }
+
+    bool open_region(SharedRegion &region, const std::string &name)
+    {
+        region.mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+        if (!region.mapping)
+            return false;
+        region.data = MapViewOfFile(region.mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+        return region.data != nullptr;
+    }
+
+    void close_region(SharedRegion &region, const std::string &, size_t)
+    {
+        if (region.data)
+            UnmapViewOfFile(region.data);
+        if (region.mapping)
+            CloseHandle(region.mapping);
+    }
+
+    typedef HANDLE WorkerProcess;
+
+    // 같은 실행 파일을 작업 모드로 실행
+    bool spawn_worker(WorkerProcess &process, const std::string &name, SharedHeader *, int w)
+    {
+        char exe_path[MAX_PATH];
+        if (GetModuleFileNameA(NULL, exe_path, MAX_PATH) == 0)
+            return false;
+
+        std::string command = std::string("\"") + exe_path + "\" " + MULTIPROCESS_WORKER_ARG + " " + name + " " +
+                              std::to_string(w);
+        STARTUPINFOA startup = {};
+        startup.cb = sizeof(startup);
+        PROCESS_INFORMATION info = {};
+        if (!CreateProcessA(exe_path, &command[0], NULL, NULL, FALSE, CREATE_NO_WINDOW, NULL, NULL, &startup, &info))
+            return false;
+
+        CloseHandle(info.hThread);
+        process = info.hProcess;
+        return true;
+    }
+
+    bool worker_exited(WorkerProcess process)
+    {
+        return WaitForSingleObject(process, 0) == WAIT_OBJECT_0;
+    }
+
+    // 취소/실패 시 작업 프로세스 강제 종료 (격자 DBSCAN 도중에는 phase를 보지 않음)
+    void kill_worker(WorkerProcess process)
+    {
+        TerminateProcess(process, 1);
+    }
+
+    void join_worker(WorkerProcess process)
+    {
+        WaitForSingleObject(process, INFINITE);
+        CloseHandle(process);
+    }
+
+    std::string region_name()
+    {
+        static int counter = 0;
+        return "Local\\dbscan_" + std::to_string(GetCurrentProcessId()) + "_" + std::to_string(counter++);
+    }
+#else
+    struct SharedRegion
+    {
+        void *data = nullptr;
+        size_t size = 0;
+    };
+
+    bool create_region(SharedRegion &region, const std::string &name, size_t size)
+    {
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0)
+            return false;
+        if (ftruncate(fd, size) != 0)
+        {
+            close(fd);
+            shm_unlink(name.c_str());
+            return false;
+        }
+
+        void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED)
+        {
+            shm_unlink(name.c_str());
+            return false;
+        }
+        region.data = data;
+        region.size = size;
+        return true;
+    }
+
+    bool open_region(SharedRegion &region, const std::string &name)
+    {
+        int fd = shm_open(name.c_str(), O_RDWR, 0600);
+        if (fd < 0)
+            return false;
+
+        struct stat info;
+        void *data = MAP_FAILED;
+        if (fstat(fd, &info) == 0)
+            data = mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED)
+            return false;
+        region.data = data;
+        region.size = info.st_size;
+        return true;
+    }
+
+    void close_region(SharedRegion &region, const std::string &name, size_t)
+    {
+        if (region.data)
+            munmap(region.data, region.size);
+        if (!name.empty())
+            shm_unlink(name.c_str());
+    }
+
+    typedef pid_t WorkerProcess;
+
+    // 같은 실행 파일을 작업 모드로 실행 (스레드가 도는 프로세스에서 fork하면 다른 스레드가 잡고 있던 잠금이 자식에 그대로 남으므로 새로 실행)
+    bool spawn_worker(WorkerProcess &process, const std::string &name, SharedHeader *, int w)
+    {
+        char exe_path[PATH_MAX];
+        ssize_t length = readlink("/proc/self/exe", exe_path, sizeof(exe_path) - 1);
+        if (length <= 0)
+            return false;
+        exe_path[length] = '\0';
+
+        std::string worker_arg = MULTIPROCESS_WORKER_ARG;
+        std::string index = std::to_string(w);
+        char *args[] = {exe_path, &worker_arg[0], const_cast<char *>(name.c_str()), &index[0], nullptr};
+        pid_t pid;
+        if (posix_spawn(&pid, exe_path, nullptr, nullptr, args, environ) != 0)
+            return false;
+
+        process = pid;
+        return true;
+    }
+
+    bool worker_exited(WorkerProcess process)
+    {
+        int status;
+        return waitpid(process, &status, WNOHANG) == process;
+    }
+
+    void kill_worker(WorkerProcess process)
+    {
+        kill(process, SIGTERM);
+    }
+
+    void join_worker(WorkerProcess process)
+    {
+        int status;
+        waitpid(process, &status, 0);
+    }
+
+    std::string region_name()
+    {
+        static int counter = 0;
+        return "/dbscan_" + std::to_string(getpid()) + "_" + std::to_string(counter++);
+    }
+#endif
+
+    // 모든 작업 프로세스가 step 단계를 끝낼 때까지 대기 (먼저 종료한 프로세스가 있거나 작업이 취소되면 실패)
+    bool wait_workers(SharedHeader *header, std::vector<WorkerProcess> &processes, std::vector<char> &exited,
+                      int step)
+    {
+        for (;;)
+        {
+            bool all_done = true;
+            for (int w = 0; w < header->workers; w++)
+            {
+                if (header->progress[w].load() >= step)
+                    continue;
+
+                all_done = false;
+                if (!exited[w] && worker_exited(processes[w]))
+                    exited[w] = 1;
+                if (exited[w] && header->progress[w].load() < step)
+                    return false;
+            }
+
+            if (all_done)
+                return true;
+            if (task_cancelled())
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+std::vector<int> dbscan_clustering_multiprocess(
+    const std::vector<Point3D> &points,
+    float radius,
+    int min_points,
+    int workers,
+    MultiprocessDbscanStats *stats)
+{
+    int n = points.size();
+    if (n == 0)
+        return std::vector<int>();
+
+    workers = std::max(1, std::min(workers, std::min(MULTIPROCESS_MAX_WORKERS, n)));
+    std::cout << "다중 프로세스 DBSCAN 시작... (작업 프로세스 " << workers << "개)" << std::endl;
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // 1. 가장 긴 축으로 정렬
+    Point3D lo = points[0], hi = points[0];
+    for (const auto &p : points)
+    {
+        lo.x = std::min(lo.x, p.x);
+        lo.y = std::min(lo.y, p.y);
+        lo.z = std::min(lo.z, p.z);
+        hi.x = std::max(hi.x, p.x);
+        hi.y = std::max(hi.y, p.y);
+        hi.z = std::max(hi.z, p.z);
+    }
+    int axis = 0;
+    if (hi.y - lo.y > hi.x - lo.x)
+        axis = 1;
+    if (hi.z - lo.z > std::max(hi.x - lo.x, hi.y - lo.y))
+        axis = 2;
+
+    auto coord = [axis](const Point3D &p)
+    { return axis == 0 ? p.x : (axis == 1 ? p.y : p.z); };
+
+    std::vector<std::pair<float, int>> keyed(n);
+    for (int i = 0; i < n; i++)
+    {
+        keyed[i] = {coord(points[i]), i};
+    }
+    std::sort(keyed.begin(), keyed.end());
+
+    // 2. 공유 메모리 구성
+    std::string name = region_name();
+    size_t bytes = shared_bytes(n);
+    SharedRegion region;
+    if (!create_region(region, name, bytes))
+    {
+        std::cerr << "공유 메모리 할당 실패 (" << bytes / (1024 * 1024) << " MB)" << std::endl;
+        close_region(region, "", bytes);
+        return std::vector<int>();
+    }
+
+    SharedHeader *header = new (region.data) SharedHeader();
+    header->n = n;
+    header->workers = workers;
+    header->radius = radius;
+    header->min_points = min_points;
+    header->threads = std::max(1, worker_count() / workers);
+    header->phase.store(1);
+
+    Point3D *shared = shared_points(header);
+    int *root = shared_root(header);
+    int *label = shared_label(header);
+    std::vector<int> position(n); // 원본 인덱스 -> 정렬 위치
+    for (int k = 0; k < n; k++)
+    {
+        shared[k] = points[keyed[k].second];
+        position[keyed[k].second] = k;
+    }
+
+    // 거리 계산 반올림으로 축 차이가 radius를 살짝 넘는 이웃도 halo에 들도록 여유
+    float reach = radius * 1.001f;
+    for (int w = 0; w <= workers; w++)
+    {
+        header->range[w] = (long long)n * w / workers;
+    }
+    for (int w = 0; w < workers; w++)
+    {
+        float first = keyed[header->range[w]].first;
+        float last = keyed[header->range[w + 1] - 1].first;
+        header->halo_begin[w] = std::lower_bound(keyed.begin(), keyed.end(), std::make_pair(first - reach, -1)) - keyed.begin();
+        header->halo_end[w] = std::upper_bound(keyed.begin(), keyed.end(), std::make_pair(last + reach, n)) - keyed.begin();
+    }
+    keyed.clear();
+    keyed.shrink_to_fit();
+
+    auto partition_end = std::chrono::high_resolution_clock::now();
+
+    // 3. 작업 프로세스 실행 -> 코어 판정 + 구간 안 병합
+    std::vector<WorkerProcess> processes;
+    std::vector<char> exited(workers, 0);
+    bool ok = true;
+    for (int w = 0; w < workers && ok; w++)
+    {
+        WorkerProcess process;
+        ok = spawn_worker(process, name, header, w);
+        if (ok)
+            processes.push_back(process);
+    }
+    if (ok)
+        ok = wait_workers(header, processes, exited, 1);
+
+    auto core_end = std::chrono::high_resolution_clock::now();
+
+    std::vector<int> labels;
+    if (ok)
+    {
+        // 4. 구간 경계 병합: 구간 w의 끝쪽 코어 -> 뒤 구간들의 halo 안 코어
+        //    (halo_begin이 단조 증가라 구간 w 점 중 뒤 구간과 이웃할 수 있는 점은 [halo_begin[w+1], range[w+1]))
+        std::vector<int> parent(root, root + n);
+        for (int w = 0; w + 1 < workers; w++)
+        {
+            int query_begin = std::max(header->halo_begin[w + 1], header->range[w]);
+            int query_end = header->range[w + 1];
+            int target_begin = header->range[w + 1];
+            int target_end = header->halo_end[w];
+            if (query_begin >= query_end || target_begin >= target_end)
+                continue;
+
+            std::vector<Point3D> targets(shared + target_begin, shared + target_end);
+            KDTree band_tree(targets);
+
+            std::vector<int> queries;
+            std::vector<Point3D> query_points;
+            for (int k = query_begin; k < query_end; k++)
+            {
+                if (root[k] >= 0)
+                {
+                    queries.push_back(k);
+                    query_points.push_back(shared[k]);
+                }
+            }
+
+            // 쿼리는 축 정렬 순서라 다른 축으로 흩어져 있음 -> 트리 순서로 묶어 패킷 탐색
+            KDTree query_tree(query_points);
+            for_each_neighbors(band_tree, query_points, query_tree.spatial_order(), radius,
+                               [&](int q, const std::vector<int> &neighbors)
+                               {
+                                   for (int j : neighbors)
+                                   {
+                                       if (root[target_begin + j] >= 0)
+                                           unite(parent, queries[q], target_begin + j);
+                                   }
+                               });
+        }
+
+        // 5. 클러스터 번호: 가장 작은 코어 원본 인덱스 순 (단일 스레드 DBSCAN과 같은 순서)
+        std::vector<int> cluster_id(n, -1);
+        int cluster_count = 0;
+        for (int i = 0; i < n; i++)
+        {
+            int k = position[i];
+            if (root[k] < 0)
+                continue;
+
+            int r = find_root(parent, k);
+            if (cluster_id[r] == -1)
+                cluster_id[r] = cluster_count++;
+        }
+        for (int k = 0; k < n; k++)
+        {
+            root[k] = root[k] >= 0 ? cluster_id[find_root(parent, k)] : -1;
+        }
+        parent.clear();
+        parent.shrink_to_fit();
+        cluster_id.clear();
+        cluster_id.shrink_to_fit();
+
+        auto merge_end = std::chrono::high_resolution_clock::now();
+
+        // 6. 작업 프로세스: 경계점 레이블
+        header->phase.store(2);
+        ok = wait_workers(header, processes, exited, 2);
+
+        if (ok)
+        {
+            labels.resize(n);
+            for (int i = 0; i < n; i++)
+            {
+                labels[i] = label[position[i]];
+            }
+
+            auto end = std::chrono::high_resolution_clock::now();
+            float slowest_core = 0.0f, slowest_border = 0.0f;
+            for (int w = 0; w < workers; w++)
+            {
+                slowest_core = std::max(slowest_core, header->core_time[w]);
+                slowest_border = std::max(slowest_border, header->border_time[w]);
+            }
+
+            if (stats)
+            {
+                stats->workers = workers;
+                stats->partition_time = std::chrono::duration<float>(partition_end - start).count();
+                stats->core_time = std::chrono::duration<float>(core_end - partition_end).count();
+                stats->merge_time = std::chrono::duration<float>(merge_end - core_end).count();
+                stats->border_time = std::chrono::duration<float>(end - merge_end).count();
+            }
+
+            std::cout << "다중 프로세스 DBSCAN 완료! 총 " << cluster_count << "개 클러스터 (가장 느린 프로세스: 코어 "
+                      << slowest_core << " s, 경계점 " << slowest_border << " s)" << std::endl;
+        }
+    }
+
+    if (!ok)
+    {
+        if (task_cancelled())
+            std::cout << "다중 프로세스 DBSCAN 취소" << std::endl;
+        else
+            std::cerr << "다중 프로세스 DBSCAN 실패 (작업 프로세스 실행 또는 비정상 종료)" << std::endl;
+
+        // 대기 중인 프로세스는 phase를 보고 끝나지만 코어 단계 중인 프로세스는 끝날 때까지 기다려야 하므로 강제 종료
+        header->phase.store(-1);
+        for (WorkerProcess process : processes)
+        {
+            kill_worker(process);
+        }
+    }
+
+    for (WorkerProcess process : processes)
+    {
+        join_worker(process);
+    }
+    header->~SharedHeader();
+    close_region(region, name, bytes);
+
+    return labels;
+}
+
+int run_multiprocess_dbscan_worker(int argc, char **argv)
+{
+    if (argc < 4)
+        return 1;
+
+    std::string name = argv[2];
+    int w = std::atoi(argv[3]);
+
+    SharedRegion region;
+    if (!open_region(region, name))
+        return 1;
+
+    SharedHeader *header = (SharedHeader *)region.data;
+    int result = w >= 0 && w < header->workers ? worker_main(header, w) : 1;
+
+    // 이름은 조정자가 정리
+    close_region(region, "", 0);
+    return result;
+}
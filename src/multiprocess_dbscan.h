@@ -0,0 +1,41 @@
+#ifndef MULTIPROCESS_DBSCAN_H
+#define MULTIPROCESS_DBSCAN_H
+
+#include <vector>
+#include "point3d.h"
+
+// 최대 작업 프로세스 수
+const int MULTIPROCESS_MAX_WORKERS = 64;
+
+// 작업 프로세스 실행 인자 (Windows: 같은 실행 파일을 "--dbscan-worker <공유 메모리 이름> <번호>"로 실행)
+const char *const MULTIPROCESS_WORKER_ARG = "--dbscan-worker";
+
+// 작업 프로세스별 시간 통계
+struct MultiprocessDbscanStats
+{
+    int workers = 0;
+    float partition_time = 0.0f; // 정렬 + 공유 메모리 복사
+    float core_time = 0.0f;      // 작업 프로세스: 코어 판정 + 구간 안 병합 (가장 느린 프로세스 기준)
+    float merge_time = 0.0f;     // 조정자: 구간 경계 병합 + 클러스터 번호
+    float border_time = 0.0f;    // 작업 프로세스: 경계점 레이블
+};
+
+// 여러 프로세스로 나눠 실행하는 DBSCAN (네트워크 없이 로컬 공유 메모리만 사용)
+// 1. 가장 긴 축으로 점을 정렬해 공유 메모리에 복사하고 점 개수가 같은 구간으로 나눔
+//    (구간 + 앞뒤 radius 폭 halo가 정렬 순서에서 연속 범위라 복제 없이 공유)
+// 2. 작업 프로세스: halo 포함 범위로 KD-Tree를 만들어 자기 구간 점의 코어 판정 + 구간 안 코어 병합
+// 3. 조정자: 구간 경계 근처 코어만 다시 탐색해 전역 union-find로 병합, 클러스터 번호 매김
+// 4. 작업 프로세스: 자기 구간 경계점 레이블
+// 레이블은 dbscan_clustering_grid와 같음
+// 프로세스 생성이나 공유 메모리 할당에 실패하면 빈 벡터 반환
+std::vector<int> dbscan_clustering_multiprocess(
+    const std::vector<Point3D> &points,
+    float radius,
+    int min_points,
+    int workers,
+    MultiprocessDbscanStats *stats = nullptr);
+
+// 작업 프로세스 진입점 (main에서 argv[1] == MULTIPROCESS_WORKER_ARG일 때 호출, 종료 코드 반환)
+int run_multiprocess_dbscan_worker(int argc, char **argv);
+
+#endif // MULTIPROCESS_DBSCAN_H
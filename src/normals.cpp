@@ -0,0 +1,183 @@
+#include "normals.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// ==================== 대칭 3x3 고유값 분해 ====================
+
+void symmetric_eigenvalues(const double a[6], double eigenvalues[3])
+{
+    double xx = a[0], xy = a[1], xz = a[2], yy = a[3], yz = a[4], zz = a[5];
+
+    double off = xy * xy + xz * xz + yz * yz;
+    double q = (xx + yy + zz) / 3.0;
+    double p2 = (xx - q) * (xx - q) + (yy - q) * (yy - q) + (zz - q) * (zz - q) + 2.0 * off;
+
+    // 대각 행렬 (또는 q*I): 대각 원소가 고유값
+    if (p2 <= 1e-30 * (q * q + 1e-300))
+    {
+        eigenvalues[0] = xx;
+        eigenvalues[1] = yy;
+        eigenvalues[2] = zz;
+        std::sort(eigenvalues, eigenvalues + 3);
+        return;
+    }
+
+    // B = (A - qI) / p, det(B) / 2 = cos(3 phi)
+    double p = std::sqrt(p2 / 6.0);
+    double bxx = (xx - q) / p, byy = (yy - q) / p, bzz = (zz - q) / p;
+    double bxy = xy / p, bxz = xz / p, byz = yz / p;
+    double det = bxx * (byy * bzz - byz * byz) - bxy * (bxy * bzz - byz * bxz) + bxz * (bxy * byz - byy * bxz);
+    double r = std::clamp(det / 2.0, -1.0, 1.0);
+    double phi = std::acos(r) / 3.0;
+
+    const double two_pi_3 = 2.0943951023931953;
+    double largest = q + 2.0 * p * std::cos(phi);
+    double smallest = q + 2.0 * p * std::cos(phi + two_pi_3);
+    eigenvalues[0] = smallest;
+    eigenvalues[1] = 3.0 * q - largest - smallest;
+    eigenvalues[2] = largest;
+}
+
+bool symmetric_eigenvector(const double a[6], double lambda, double vector[3])
+{
+    double r0[3] = {a[0] - lambda, a[1], a[2]};
+    double r1[3] = {a[1], a[3] - lambda, a[4]};
+    double r2[3] = {a[2], a[4], a[5] - lambda};
+
+    auto cross = [](const double *u, const double *v, double *out)
+    {
+        out[0] = u[1] * v[2] - u[2] * v[1];
+        out[1] = u[2] * v[0] - u[0] * v[2];
+        out[2] = u[0] * v[1] - u[1] * v[0];
+        return out[0] * out[0] + out[1] * out[1] + out[2] * out[2];
+    };
+
+    // 고유값이 한 번만 나오면 A - lambda I의 계수가 2 -> 두 행의 외적이 고유벡터
+    double c[3][3];
+    double lengths[3] = {cross(r0, r1, c[0]), cross(r0, r2, c[1]), cross(r1, r2, c[2])};
+    int best = std::max_element(lengths, lengths + 3) - lengths;
+
+    double row_lengths[3] = {r0[0] * r0[0] + r0[1] * r0[1] + r0[2] * r0[2],
+                             r1[0] * r1[0] + r1[1] * r1[1] + r1[2] * r1[2],
+                             r2[0] * r2[0] + r2[1] * r2[1] + r2[2] * r2[2]};
+    int longest_row = std::max_element(row_lengths, row_lengths + 3) - row_lengths;
+    if (row_lengths[longest_row] <= 0.0)
+        return false;
+
+    double length = lengths[best];
+    if (length > 1e-12 * row_lengths[longest_row] * row_lengths[longest_row])
+    {
+        double inv = 1.0 / std::sqrt(length);
+        vector[0] = c[best][0] * inv;
+        vector[1] = c[best][1] * inv;
+        vector[2] = c[best][2] * inv;
+        return true;
+    }
+
+    // 중복 고유값 (계수 1): 남은 행에 수직인 아무 벡터 (행과 가장 덜 평행한 축과의 외적)
+    const double *row = longest_row == 0 ? r0 : (longest_row == 1 ? r1 : r2);
+    double axis[3] = {0.0, 0.0, 0.0};
+    int least = 0;
+    for (int d = 1; d < 3; d++)
+    {
+        if (std::abs(row[d]) < std::abs(row[least]))
+            least = d;
+    }
+    axis[least] = 1.0;
+
+    double out[3];
+    double inv = 1.0 / std::sqrt(cross(row, axis, out));
+    vector[0] = out[0] * inv;
+    vector[1] = out[1] * inv;
+    vector[2] = out[2] * inv;
+    return true;
+}
+
+// ==================== 법선 추정 ====================
+
+PointNormals estimate_normals(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    const std::vector<bool> &active,
+    int k,
+    const Point3D &viewpoint)
+{
+    int n = points.size();
+    PointNormals result;
+    result.nx.assign(n, 0.0f);
+    result.ny.assign(n, 0.0f);
+    result.nz.assign(n, 0.0f);
+    result.curvature.assign(n, 0.0f);
+
+    std::cout << "법선 추정 시작... (k = " << k << ")" << std::endl;
+
+    KDTreeFilter filter = tree.make_filter(active);
+    std::vector<int> order = tree.spatial_order();
+
+    parallel_for(0, n, 4096, [&](int begin, int end, int)
+                 {
+                     std::vector<int> indices;
+                     std::vector<float> distances;
+                     for (int j = begin; j < end; j++)
+                     {
+                         int i = order[j];
+                         if (!active[i])
+                             continue;
+
+                         tree.find_knn(points[i], k, indices, distances, &filter);
+                         int m = indices.size();
+                         if (m < 3)
+                             continue;
+
+                         // 평균을 뺀 공분산 (큰 좌표에서 자릿수 손실을 막으려고 double)
+                         double cx = 0, cy = 0, cz = 0;
+                         for (int idx : indices)
+                         {
+                             cx += points[idx].x;
+                             cy += points[idx].y;
+                             cz += points[idx].z;
+                         }
+                         cx /= m;
+                         cy /= m;
+                         cz /= m;
+
+                         double cov[6] = {0, 0, 0, 0, 0, 0};
+                         for (int idx : indices)
+                         {
+                             double dx = points[idx].x - cx, dy = points[idx].y - cy, dz = points[idx].z - cz;
+                             cov[0] += dx * dx;
+                             cov[1] += dx * dy;
+                             cov[2] += dx * dz;
+                             cov[3] += dy * dy;
+                             cov[4] += dy * dz;
+                             cov[5] += dz * dz;
+                         }
+
+                         double eigenvalues[3];
+                         symmetric_eigenvalues(cov, eigenvalues);
+                         double normal[3];
+                         if (!symmetric_eigenvector(cov, eigenvalues[0], normal))
+                             continue;
+
+                         // viewpoint 쪽을 향하도록
+                         double vx = viewpoint.x - points[i].x, vy = viewpoint.y - points[i].y, vz = viewpoint.z - points[i].z;
+                         if (normal[0] * vx + normal[1] * vy + normal[2] * vz < 0)
+                         {
+                             normal[0] = -normal[0];
+                             normal[1] = -normal[1];
+                             normal[2] = -normal[2];
+                         }
+
+                         double sum = eigenvalues[0] + eigenvalues[1] + eigenvalues[2];
+                         result.nx[i] = normal[0];
+                         result.ny[i] = normal[1];
+                         result.nz[i] = normal[2];
+                         result.curvature[i] = sum > 0 ? std::max(eigenvalues[0], 0.0) / sum : 0.0;
+                     }
+                 });
+
+    std::cout << "법선 추정 완료!" << std::endl;
+    return result;
+}
@@ -0,0 +1,35 @@
+#ifndef NORMALS_H
+#define NORMALS_H
+
+#include <vector>
+#include "point3d.h"
+#include "kdtree.h"
+
+// 점별 법선 + 곡률 (SoA, 원본 인덱스 기준)
+struct PointNormals
+{
+    std::vector<float> nx, ny, nz; // 단위 법선 (계산하지 못한 점은 0 벡터)
+    std::vector<float> curvature;  // 표면 변화량 = 가장 작은 고유값 / 고유값 합 (0: 평면 ~ 1/3: 등방)
+
+    size_t size() const { return nx.size(); }
+    bool empty() const { return nx.empty(); }
+};
+
+// 대칭 3x3 행렬 (xx, xy, xz, yy, yz, zz)의 고유값을 오름차순으로 (삼각함수 닫힌 해)
+void symmetric_eigenvalues(const double a[6], double eigenvalues[3]);
+
+// 대칭 3x3 행렬에서 고유값 lambda의 단위 고유벡터 (A - lambda I의 행 외적 중 가장 긴 것)
+// 행렬이 0이면 false
+bool symmetric_eigenvector(const double a[6], double lambda, double vector[3]);
+
+// k-최근접 이웃(자신 포함)의 공분산 PCA로 법선/곡률 추정
+// 트리 순서 블록을 병렬로 나눠 계산하고, 법선은 viewpoint를 향하도록 방향을 맞춤
+// active가 아닌 점과 이웃이 3개 미만인 점은 0 (이웃도 active인 점에서만 찾음)
+PointNormals estimate_normals(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    const std::vector<bool> &active,
+    int k,
+    const Point3D &viewpoint);
+
+#endif // NORMALS_H
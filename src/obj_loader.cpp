@@ -1,8 +1,11 @@
 // src/obj_loader.cpp
 #include "obj_loader.h"
+#include "normals.h"
+#include "parallel.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <cstdio>
 #include <cstring>
 
 // ========== 보조 함수 ==========
@@ -108,6 +111,11 @@ OBJMesh *load_obj(const std::string &filename)
 
     std::cout << "OBJ 파일 읽는 중: " << filename << std::endl;
 
+    // 진행률 = 읽은 바이트
+    file.seekg(0, std::ios::end);
+    task_begin_stage(file.tellg());
+    file.seekg(0, std::ios::beg);
+
     OBJMesh *mesh = new OBJMesh();
 
     std::string line;
@@ -180,6 +188,16 @@ OBJMesh *load_obj(const std::string &filename)
         {
             std::cout << "  진행: " << line_num << " 줄" << std::endl;
         }
+        if (line_num % 16384 == 0)
+        {
+            task_set_progress(file.tellg());
+            if (task_cancelled())
+            {
+                std::cout << "OBJ 로드 취소" << std::endl;
+                delete mesh;
+                return nullptr;
+            }
+        }
     }
 
     file.close();
@@ -208,18 +226,47 @@ void free_mesh(OBJMesh *mesh)
     delete mesh;
 }
 
-void save_filtered_mesh(const OBJMesh *mesh, const std::vector<bool> &is_noise,
-                        const std::string &output_path)
+int save_filtered_mesh(const OBJMesh *mesh, const std::vector<bool> &is_noise,
+                       const std::string &output_path, const PointNormals *point_normals)
 {
     std::ofstream file(output_path);
     if (!file.is_open())
     {
         std::cerr << "파일 저장 실패: " << output_path << std::endl;
-        return;
+        return 0;
     }
 
     std::cout << "\n 필터링된 메시 저장 중..." << std::endl;
 
+    // 메시 법선이 없을 때만 추정 법선 사용 (정점 번호 = 법선 번호)
+    bool estimated_normals = mesh->normals.empty() && point_normals &&
+                             point_normals->size() == mesh->vertices.size();
+
+    // 추정하지 못한 정점(0 벡터)도 vn 0 0 0으로 써서 정점 번호 = 법선 번호를 유지하고, 그 정점을 쓰는 면은 법선 없이 저장
+    auto has_normal = [&](int i)
+    {
+        return point_normals->nx[i] != 0.0f || point_normals->ny[i] != 0.0f || point_normals->nz[i] != 0.0f;
+    };
+    int missing_normals = 0;
+
+    size_t normal_count = estimated_normals ? point_normals->size() : mesh->normals.size();
+
+    // 진행률 = 처리한 정점/법선/텍스처/면 수, 취소되면 쓰다 만 파일 삭제
+    task_begin_stage(mesh->vertices.size() + normal_count + mesh->texcoords.size() + mesh->faces.size());
+    auto cancelled = [&](size_t i)
+    {
+        if (i % 16384 != 0)
+            return false;
+        task_advance(16384);
+        if (!task_cancelled())
+            return false;
+
+        file.close();
+        std::remove(output_path.c_str());
+        std::cout << "저장 취소: " << output_path << std::endl;
+        return true;
+    };
+
     // 새 정점 인덱스 매핑 (노이즈 제거 후)
     std::vector<int> new_index(mesh->vertices.size(), -1);
     int new_vertex_count = 0;
@@ -249,21 +296,34 @@ void save_filtered_mesh(const OBJMesh *mesh, const std::vector<bool> &is_noise,
         {
             std::cout << "  정점: " << i << " / " << mesh->vertices.size() << std::endl;
         }
+        if (cancelled(i))
+            return missing_normals;
     }
 
     // 2. 법선 저장 (정상 정점의 법선만)
-    for (size_t i = 0; i < mesh->normals.size(); i++)
+    for (size_t i = 0; i < normal_count; i++)
     {
         if (i < mesh->vertices.size() && !is_noise[i])
         {
-            const Normal &n = mesh->normals[i];
-            file << "vn " << n.x << " " << n.y << " " << n.z << "\n";
+            if (estimated_normals)
+            {
+                file << "vn " << point_normals->nx[i] << " " << point_normals->ny[i] << " " << point_normals->nz[i] << "\n";
+                if (!has_normal(i))
+                    missing_normals++;
+            }
+            else
+            {
+                const Normal &n = mesh->normals[i];
+                file << "vn " << n.x << " " << n.y << " " << n.z << "\n";
+            }
         }
 
         if (i % 100000 == 0)
         {
-            std::cout << "  법선: " << i << " / " << mesh->normals.size() << std::endl;
+            std::cout << "  법선: " << i << " / " << normal_count << std::endl;
         }
+        if (cancelled(i))
+            return missing_normals;
     }
 
     // 3. 텍스처 좌표 저장 (있으면)
@@ -279,6 +339,8 @@ void save_filtered_mesh(const OBJMesh *mesh, const std::vector<bool> &is_noise,
         {
             std::cout << "  텍스처: " << i << " / " << mesh->texcoords.size() << std::endl;
         }
+        if (cancelled(i))
+            return missing_normals;
     }
 
     // 4. 면 저장 (모든 정점이 정상인 면만)
@@ -311,6 +373,12 @@ void save_filtered_mesh(const OBJMesh *mesh, const std::vector<bool> &is_noise,
                      << v1 << "//" << vn1 << " "
                      << v2 << "//" << vn2 << "\n";
             }
+            else if (estimated_normals && has_normal(f.v[0]) && has_normal(f.v[1]) && has_normal(f.v[2]))
+            {
+                file << "f " << v0 << "//" << v0 << " "
+                     << v1 << "//" << v1 << " "
+                     << v2 << "//" << v2 << "\n";
+            }
             else
             {
                 file << "f " << v0 << " " << v1 << " " << v2 << "\n";
@@ -323,6 +391,8 @@ void save_filtered_mesh(const OBJMesh *mesh, const std::vector<bool> &is_noise,
         {
             std::cout << "  면: " << i << " / " << mesh->faces.size() << std::endl;
         }
+        if (cancelled(i))
+            return missing_normals;
     }
 
     file.close();
@@ -330,4 +400,9 @@ void save_filtered_mesh(const OBJMesh *mesh, const std::vector<bool> &is_noise,
     std::cout << " 저장 완료: " << output_path << std::endl;
     std::cout << "   정점: " << new_vertex_count << " (원본: " << mesh->vertices.size() << ")" << std::endl;
     std::cout << "   면: " << valid_face_count << " (원본: " << mesh->faces.size() << ")" << std::endl;
+    if (missing_normals > 0)
+    {
+        std::cout << "   추정 법선이 없는 정점: " << missing_normals << " (vn 0 0 0)" << std::endl;
+    }
+    return missing_normals;
 }
\ No newline at end of file
@@ -50,13 +50,19 @@ struct OBJMesh
 
 // ========== 함수 선언 ==========
 
+struct PointNormals; // normals.h (점별 추정 법선)
+
 // OBJ 파일 로드
 OBJMesh *load_obj(const std::string &filename);
 
 // 메모리 해제
 void free_mesh(OBJMesh *mesh);
 
-void save_filtered_mesh(const OBJMesh *mesh, const std::vector<bool> &is_noise,
-                        const std::string &output_path);
+// is_noise가 false인 정점과 그 정점만 쓰는 면 저장
+// 메시에 법선이 없고 point_normals(정점 수와 같은 크기)가 있으면 추정 법선을 정점별 vn으로 저장
+// 추정하지 못한 정점은 vn 0 0 0 (정점 번호 = 법선 번호 유지), 그 정점을 쓰는 면은 법선 없이 저장
+// 반환: vn 0 0 0으로 쓴 남은 정점 수
+int save_filtered_mesh(const OBJMesh *mesh, const std::vector<bool> &is_noise,
+                       const std::string &output_path, const PointNormals *point_normals = nullptr);
 
 #endif // OBJ_loader_H
\ No newline at end of file
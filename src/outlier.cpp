@@ -0,0 +1,319 @@
+#include "outlier.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+std::vector<bool> statistical_outlier_mask(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    const std::vector<bool> &active,
+    int k,
+    float std_ratio,
+    OutlierFilterStats *stats)
+{
+    int n = points.size();
+    std::vector<bool> keep = active;
+
+    std::cout << "통계적 이상점 제거 시작... (k = " << k << ", 기준 = 평균 + " << std_ratio << " x 표준편차)"
+              << std::endl;
+
+    KDTreeFilter filter = tree.make_filter(active);
+    std::vector<int> order = tree.spatial_order();
+
+    // 1. 점별 k-최근접 평균 거리 (-1: 검사 안 함)
+    //    vector<bool>은 스레드별로 다른 원소를 써도 같은 워드를 공유하므로 거리 배열에 먼저 기록
+    std::vector<float> mean_distances(n, -1.0f);
+
+    struct Moments
+    {
+        double sum = 0.0, sum_sq = 0.0;
+        long long count = 0;
+    };
+    std::vector<Moments> moments(worker_count());
+
+    parallel_for(0, n, 4096, [&](int begin, int end, int thread_id)
+                 {
+                     std::vector<int> indices;
+                     std::vector<float> distances;
+                     Moments &local = moments[thread_id];
+                     for (int j = begin; j < end; j++)
+                     {
+                         int i = order[j];
+                         if (!active[i])
+                             continue;
+
+                         // 자신이 결과에 포함되므로 k + 1개 탐색 후 자신 제외
+                         tree.find_knn(points[i], k + 1, indices, distances, &filter);
+
+                         double sum = 0.0;
+                         int count = 0;
+                         bool self_skipped = false;
+                         for (size_t m = 0; m < indices.size() && count < k; m++)
+                         {
+                             if (!self_skipped && indices[m] == i)
+                             {
+                                 self_skipped = true;
+                                 continue;
+                             }
+                             sum += distances[m];
+                             count++;
+                         }
+
+                         // 활성 점이 자신뿐이면 판단하지 않음
+                         if (count == 0)
+                             continue;
+
+                         float mean = sum / count;
+                         mean_distances[i] = mean;
+                         local.sum += mean;
+                         local.sum_sq += (double)mean * mean;
+                         local.count++;
+                     }
+                 });
+
+    // 2. 전체 평균/표준편차 -> 기준 거리
+    Moments total;
+    for (const Moments &m : moments)
+    {
+        total.sum += m.sum;
+        total.sum_sq += m.sum_sq;
+        total.count += m.count;
+    }
+
+    OutlierFilterStats result;
+    if (total.count > 0)
+    {
+        double mean = total.sum / total.count;
+        double variance = std::max(0.0, total.sum_sq / total.count - mean * mean);
+        result.mean_distance = mean;
+        result.stddev = std::sqrt(variance);
+        result.threshold = mean + std_ratio * result.stddev;
+    }
+
+    // 3. 마스크 (직렬, 비트 쓰기)
+    for (int i = 0; i < n; i++)
+    {
+        if (!active[i])
+            continue;
+
+        result.checked++;
+        if (mean_distances[i] > result.threshold)
+        {
+            keep[i] = false;
+            result.removed++;
+        }
+    }
+
+    std::cout << "통계적 이상점 제거 완료! 평균 거리 " << result.mean_distance << ", 표준편차 " << result.stddev
+              << ", 제거 " << result.removed << " / " << result.checked << std::endl;
+
+    if (stats)
+        *stats = result;
+
+    return keep;
+}
+
+std::vector<bool> radius_outlier_mask(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    const std::vector<bool> &active,
+    float radius,
+    int min_neighbors,
+    OutlierFilterStats *stats)
+{
+    int n = points.size();
+    std::vector<bool> keep = active;
+
+    std::cout << "반경 이상점 제거 시작... (반경 = " << radius << ", 최소 이웃 = " << min_neighbors << ")" << std::endl;
+
+    KDTreeFilter filter = tree.make_filter(active);
+    std::vector<int> order = tree.spatial_order();
+
+    // 1. 점별 판정 (0: 검사 안 함, 1: 유지, 2: 제거), 자신도 개수에 들어가므로 min_neighbors + 1개에서 멈춤
+    std::vector<char> verdict(n, 0);
+    int limit = min_neighbors + 1;
+
+    parallel_for(0, n, OUTLIER_COUNT_BLOCK, [&](int begin, int end, int)
+                 {
+                     std::vector<int> ids;
+                     std::vector<Point3D> targets;
+                     std::vector<int> counts;
+                     ids.reserve(end - begin);
+                     targets.reserve(end - begin);
+                     for (int j = begin; j < end; j++)
+                     {
+                         int i = order[j];
+                         if (!active[i])
+                             continue;
+                         ids.push_back(i);
+                         targets.push_back(points[i]);
+                     }
+
+                     counts.resize(ids.size());
+                     tree.count_radius_packet_limit(targets.data(), targets.size(), radius, limit, counts.data(), &filter);
+
+                     for (size_t m = 0; m < ids.size(); m++)
+                         verdict[ids[m]] = counts[m] >= limit ? 1 : 2;
+                 });
+
+    // 2. 마스크 (직렬, 비트 쓰기)
+    OutlierFilterStats result;
+    for (int i = 0; i < n; i++)
+    {
+        if (verdict[i] == 0)
+            continue;
+
+        result.checked++;
+        if (verdict[i] == 2)
+        {
+            keep[i] = false;
+            result.removed++;
+        }
+    }
+
+    std::cout << "반경 이상점 제거 완료! 제거 " << result.removed << " / " << result.checked << std::endl;
+
+    if (stats)
+        *stats = result;
+
+    return keep;
+}
+
+KnnGraph build_knn_graph(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    const std::vector<bool> &active,
+    int k)
+{
+    int n = points.size();
+    KnnGraph graph;
+    graph.k = k;
+    graph.active = active;
+    graph.order = tree.spatial_order();
+    graph.neighbors.assign((size_t)n * k, -1);
+
+    std::cout << "k-최근접 그래프 구축 시작... (k = " << k << ")" << std::endl;
+
+    KDTreeFilter filter = tree.make_filter(active);
+
+    parallel_for(0, n, 4096, [&](int begin, int end, int)
+                 {
+                     std::vector<int> indices;
+                     std::vector<float> distances;
+                     for (int j = begin; j < end; j++)
+                     {
+                         int i = graph.order[j];
+                         if (!active[i])
+                             continue;
+
+                         // 자신이 결과에 포함되므로 k + 1개 탐색 후 자신 제외
+                         tree.find_knn(points[i], k + 1, indices, distances, &filter);
+
+                         int *row = &graph.neighbors[(size_t)i * k];
+                         int count = 0;
+                         bool self_skipped = false;
+                         for (size_t m = 0; m < indices.size() && count < k; m++)
+                         {
+                             if (!self_skipped && indices[m] == i)
+                             {
+                                 self_skipped = true;
+                                 continue;
+                             }
+                             row[count++] = indices[m];
+                         }
+                     }
+                 });
+
+    std::cout << "k-최근접 그래프 구축 완료! (" << ((size_t)n * k * sizeof(int) >> 20) << " MB)" << std::endl;
+    return graph;
+}
+
+std::vector<float> local_outlier_factor(
+    const std::vector<Point3D> &points,
+    const KnnGraph &graph,
+    int k)
+{
+    int n = points.size();
+    k = std::min(k, graph.k);
+    std::vector<float> scores(n, 0.0f);
+    if (k <= 0)
+        return scores;
+
+    std::cout << "LOF 계산 시작... (k = " << k << ")" << std::endl;
+
+    auto distance = [&](int a, int b)
+    {
+        float dx = points[a].x - points[b].x;
+        float dy = points[a].y - points[b].y;
+        float dz = points[a].z - points[b].z;
+        return std::sqrt(dx * dx + dy * dy + dz * dz);
+    };
+
+    // 1. k-거리 (이웃이 k개보다 적으면 있는 이웃 중 가장 먼 거리)
+    std::vector<float> k_distance(n, 0.0f);
+    parallel_for(0, n, 65536, [&](int begin, int end, int)
+                 {
+                     for (int j = begin; j < end; j++)
+                     {
+                         int i = graph.order[j];
+                         if (!graph.active[i])
+                             continue;
+                         const int *row = graph.row(i);
+                         for (int m = k - 1; m >= 0; m--)
+                         {
+                             if (row[m] >= 0)
+                             {
+                                 k_distance[i] = distance(i, row[m]);
+                                 break;
+                             }
+                         }
+                     }
+                 });
+
+    // 2. 국소 도달 밀도
+    const float min_reach = 1e-6f;
+    std::vector<float> lrd(n, 0.0f);
+    parallel_for(0, n, 16384, [&](int begin, int end, int)
+                 {
+                     for (int j = begin; j < end; j++)
+                     {
+                         int i = graph.order[j];
+                         if (!graph.active[i])
+                             continue;
+                         const int *row = graph.row(i);
+                         double sum = 0.0;
+                         int count = 0;
+                         for (int m = 0; m < k && row[m] >= 0; m++)
+                         {
+                             sum += std::max(k_distance[row[m]], distance(i, row[m]));
+                             count++;
+                         }
+                         if (count > 0)
+                             lrd[i] = 1.0f / std::max((float)(sum / count), min_reach);
+                     }
+                 });
+
+    // 3. LOF (이웃이 없으면 1)
+    parallel_for(0, n, 16384, [&](int begin, int end, int)
+                 {
+                     for (int j = begin; j < end; j++)
+                     {
+                         int i = graph.order[j];
+                         if (!graph.active[i])
+                             continue;
+                         const int *row = graph.row(i);
+                         double sum = 0.0;
+                         int count = 0;
+                         for (int m = 0; m < k && row[m] >= 0; m++)
+                         {
+                             sum += lrd[row[m]];
+                             count++;
+                         }
+                         scores[i] = count > 0 ? (float)(sum / count / lrd[i]) : 1.0f;
+                     }
+                 });
+
+    std::cout << "LOF 계산 완료!" << std::endl;
+    return scores;
+}
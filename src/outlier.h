@@ -0,0 +1,76 @@
+#ifndef OUTLIER_H
+#define OUTLIER_H
+
+#include <vector>
+#include "point3d.h"
+#include "kdtree.h"
+
+// 이상점 필터 통계
+struct OutlierFilterStats
+{
+    int checked = 0; // 검사한 점 수 (active인 점)
+    int removed = 0;
+    float mean_distance = 0.0f; // 통계 필터: 점별 k-최근접 평균 거리의 전체 평균
+    float stddev = 0.0f;        // 통계 필터: 위 값의 표준편차
+    float threshold = 0.0f;     // 통계 필터: 제거 기준 거리
+};
+
+// 반경 이상점 마스크를 만들 때 개수 탐색을 묶는 단위 (트리 순서로 연속한 점 = 가까운 점)
+const int OUTLIER_COUNT_BLOCK = 256;
+
+// 통계적 이상점 제거 (Statistical Outlier Removal)
+// 점별로 자신을 뺀 k-최근접 이웃까지의 평균 거리 d_i를 병렬로 구하고 (트리 순서 블록)
+// d_i > mean(d) + std_ratio * stddev(d)인 점을 제거
+// active인 점만 검사하고 이웃도 active인 점에서만 찾음 (트리는 points 전체로 만든 것을 필터로 재사용)
+// 반환: 남길 점 마스크 (active가 아니던 점은 false)
+std::vector<bool> statistical_outlier_mask(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    const std::vector<bool> &active,
+    int k,
+    float std_ratio,
+    OutlierFilterStats *stats = nullptr);
+
+// 반경 이상점 제거 (Radius Outlier Removal)
+// 자신을 뺀 radius 이내 active 이웃이 min_neighbors개 미만인 점을 제거
+// 트리 순서 블록을 병렬로 나눠 패킷 개수 탐색을 하고, 쿼리마다 min_neighbors개를 찾으면 탐색을 멈춤
+// active/반환값의 의미는 statistical_outlier_mask와 같음
+std::vector<bool> radius_outlier_mask(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    const std::vector<bool> &active,
+    float radius,
+    int min_neighbors,
+    OutlierFilterStats *stats = nullptr);
+
+// k-최근접 이웃 그래프 (점마다 자신을 뺀 k개 이웃, 가까운 순, 모자라면 -1)
+// active가 같으면 k 이하의 어떤 k'에도 앞 k'개를 그대로 재사용
+struct KnnGraph
+{
+    int k = 0;
+    std::vector<int> neighbors; // n * k
+    std::vector<bool> active;   // 그래프를 만든 점 (이웃도 이 점들 중에서만)
+    std::vector<int> order;     // 트리 순서 (이후 병렬 단계도 이 순서로 블록을 나눔)
+
+    bool empty() const { return k == 0; }
+    const int *row(int i) const { return &neighbors[(size_t)i * k]; }
+};
+
+// active인 점마다 k-최근접 이웃 (트리 순서 블록을 병렬로)
+KnnGraph build_knn_graph(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    const std::vector<bool> &active,
+    int k);
+
+// 국소 이상치 계수 (Local Outlier Factor), graph의 앞 k개 이웃 사용 (k <= graph.k)
+// k-거리(o) = o의 k번째 이웃 거리, 도달 거리(p, o) = max(k-거리(o), |p - o|)
+// lrd(p) = 1 / 평균 도달 거리(p, N_k(p)), LOF(p) = 평균 lrd(N_k(p)) / lrd(p)
+// 1 근처면 주변과 밀도가 같고 클수록 주변보다 희박 (중복점으로 평균 도달 거리가 0이 되지 않게 1e-6으로 제한)
+// k-거리, lrd, LOF 세 단계를 각각 병렬로 계산, active가 아닌 점의 점수는 0
+std::vector<float> local_outlier_factor(
+    const std::vector<Point3D> &points,
+    const KnnGraph &graph,
+    int k);
+
+#endif // OUTLIER_H
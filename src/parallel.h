@@ -0,0 +1,171 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// 작업 스레드 상한 (0이면 제한 없음, 여러 프로세스가 코어를 나눠 쓸 때 프로세스별로 설정)
+inline std::atomic<int> worker_limit{0};
+
+// 작업 스레드 수 (하드웨어 스레드 수, 알 수 없으면 1, worker_limit이 있으면 그 이하)
+inline int worker_count()
+{
+    unsigned n = std::thread::hardware_concurrency();
+    int count = n == 0 ? 1 : (int)n;
+    int limit = worker_limit.load(std::memory_order_relaxed);
+    return limit > 0 ? std::min(count, limit) : count;
+}
+
+// 백그라운드 작업 진행률/취소 (BackgroundJob이 설정, parallel_for와 긴 직렬 루프에서 확인)
+struct TaskControl
+{
+    std::atomic<bool> cancel{false};
+    std::atomic<long long> done{0};  // 현재 단계에서 끝난 양
+    std::atomic<long long> total{0}; // 현재 단계 전체 양 (0이면 알 수 없음)
+    std::atomic<bool> held{false};   // true면 parallel_for가 단계를 바꾸지 않음 (바깥 루프가 진행률을 직접 올림)
+};
+
+// 실행 중인 백그라운드 작업 (없으면 nullptr, 한 번에 하나)
+inline std::atomic<TaskControl *> current_task{nullptr};
+
+// 취소 요청 여부 (작업 밖에서 호출하면 항상 false)
+inline bool task_cancelled()
+{
+    TaskControl *task = current_task.load(std::memory_order_relaxed);
+    return task && task->cancel.load(std::memory_order_relaxed);
+}
+
+// 새 단계 시작 (진행률 0으로)
+inline void task_begin_stage(long long total)
+{
+    TaskControl *task = current_task.load(std::memory_order_relaxed);
+    if (task)
+    {
+        task->done.store(0, std::memory_order_relaxed);
+        task->total.store(total, std::memory_order_relaxed);
+    }
+}
+
+inline void task_set_progress(long long done)
+{
+    TaskControl *task = current_task.load(std::memory_order_relaxed);
+    if (task)
+        task->done.store(done, std::memory_order_relaxed);
+}
+
+inline void task_advance(long long amount)
+{
+    TaskControl *task = current_task.load(std::memory_order_relaxed);
+    if (task)
+        task->done.fetch_add(amount, std::memory_order_relaxed);
+}
+
+// 타일별 처리처럼 바깥 루프가 단위마다 parallel_for를 돌릴 때 바깥 진행률을 유지
+// hold = true 동안 parallel_for는 단계를 새로 시작하거나 진행률을 올리지 않음
+inline void task_hold_stage(bool hold)
+{
+    TaskControl *task = current_task.load(std::memory_order_relaxed);
+    if (task)
+        task->held.store(hold, std::memory_order_relaxed);
+}
+
+inline bool task_stage_held()
+{
+    TaskControl *task = current_task.load(std::memory_order_relaxed);
+    return task && task->held.load(std::memory_order_relaxed);
+}
+
+// [begin, end) 범위를 chunk 크기 블록으로 나눠 여러 스레드에서 실행
+// func(block_begin, block_end, thread_id) - thread_id는 0 ~ worker_count()-1
+// 블록은 atomic 카운터로 동적 분배 (점 밀도에 따라 블록 비용이 달라서)
+// 백그라운드 작업 중이면 블록 단위로 진행률을 올리고, 취소되면 남은 블록은 건너뜀 (결과는 버려짐)
+template <typename Func>
+void parallel_for(int begin, int end, int chunk, Func func)
+{
+    if (begin >= end)
+        return;
+    if (chunk < 1)
+        chunk = 1;
+
+    int block_count = (end - begin + chunk - 1) / chunk;
+    int threads = std::min(worker_count(), block_count);
+
+    bool report = !task_stage_held();
+    if (report)
+        task_begin_stage(block_count);
+
+    std::atomic<int> next_block(0);
+    auto worker = [&](int thread_id)
+    {
+        for (;;)
+        {
+            int block = next_block.fetch_add(1);
+            if (block >= block_count || task_cancelled())
+                break;
+            int b = begin + block * chunk;
+            int e = std::min(end, b + chunk);
+            func(b, e, thread_id);
+            if (report)
+                task_advance(1);
+        }
+    };
+
+    if (threads <= 1)
+    {
+        worker(0);
+        return;
+    }
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++)
+    {
+        pool.emplace_back(worker, t);
+    }
+    worker(0);
+
+    for (auto &th : pool)
+    {
+        th.join();
+    }
+}
+
+// values를 스레드 수만큼 블록으로 나눠 병렬 정렬한 뒤 이웃 블록끼리 병렬 병합 (결과는 std::sort와 같음)
+// 한 스레드면 std::sort 그대로
+template <typename T>
+void parallel_sort(std::vector<T> &values)
+{
+    int n = values.size();
+    int threads = std::min(worker_count(), std::max(n / 65536, 1));
+    if (threads <= 1)
+    {
+        std::sort(values.begin(), values.end());
+        return;
+    }
+
+    int block = (n + threads - 1) / threads;
+    parallel_for(0, threads, 1, [&](int begin, int end, int)
+                 {
+                     for (int b = begin; b < end; b++)
+                         std::sort(values.begin() + std::min(n, b * block), values.begin() + std::min(n, (b + 1) * block));
+                 });
+
+    // 정렬된 구간 폭을 두 배씩 늘리며 병합
+    for (long long width = block; width < n; width *= 2)
+    {
+        int pairs = (n + 2 * width - 1) / (2 * width);
+        parallel_for(0, pairs, 1, [&](int begin, int end, int)
+                     {
+                         for (int pair = begin; pair < end; pair++)
+                         {
+                             long long lo = pair * 2 * width;
+                             long long mid = std::min<long long>(n, lo + width);
+                             long long hi = std::min<long long>(n, lo + 2 * width);
+                             std::inplace_merge(values.begin() + lo, values.begin() + mid, values.begin() + hi);
+                         }
+                     });
+    }
+}
+
+#endif // PARALLEL_H
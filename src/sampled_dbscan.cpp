@@ -0,0 +1,329 @@
+#include "sampled_dbscan.h"
+#include "clustering.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <map>
+
+std::vector<int> dbscan_clustering_sampled(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    float radius,
+    int min_points,
+    float voxel_size,
+    SampledDbscanStats *stats)
+{
+    int n = points.size();
+    std::vector<int> labels(n, -1);
+
+    if (n == 0)
+        return labels;
+
+    std::cout << "샘플링 DBSCAN 시작... (복셀 " << voxel_size << ")" << std::endl;
+
+    // 1. 복셀 키로 점 정렬 (키 한 축 21비트, 넘치면 복셀 확대)
+    Point3D lo = points[0], hi = points[0];
+    for (const auto &p : points)
+    {
+        lo.x = std::min(lo.x, p.x);
+        lo.y = std::min(lo.y, p.y);
+        lo.z = std::min(lo.z, p.z);
+        hi.x = std::max(hi.x, p.x);
+        hi.y = std::max(hi.y, p.y);
+        hi.z = std::max(hi.z, p.z);
+    }
+
+    const double max_cells = (1 << 21) - 1;
+    double extent = std::max((double)hi.x - lo.x, std::max((double)hi.y - lo.y, (double)hi.z - lo.z));
+    double voxel = voxel_size > 0 ? voxel_size : radius;
+    if (extent / voxel >= max_cells)
+    {
+        voxel = extent / (max_cells - 1);
+        std::cout << "  복셀이 너무 작음 -> " << voxel << "로 확대" << std::endl;
+    }
+
+    std::vector<std::pair<uint64_t, int>> keyed(n);
+    parallel_for(0, n, 65536, [&](int begin, int end, int)
+                 {
+                     for (int i = begin; i < end; i++)
+                     {
+                         uint64_t ix = (uint64_t)((points[i].x - (double)lo.x) / voxel);
+                         uint64_t iy = (uint64_t)((points[i].y - (double)lo.y) / voxel);
+                         uint64_t iz = (uint64_t)((points[i].z - (double)lo.z) / voxel);
+                         keyed[i] = {ix << 42 | iy << 21 | iz, i};
+                     }
+                 });
+    std::sort(keyed.begin(), keyed.end());
+
+    // 2. 복셀 대표점 (중심) + 가중치, 점 -> 복셀 번호
+    std::vector<Point3D> reps;
+    std::vector<int> weight;
+    std::vector<int> voxel_of(n);
+    std::vector<int> sorted(n); // 복셀 순서 (공간적으로 모여 있어 패킷 탐색용)
+    double sx = 0, sy = 0, sz = 0;
+    int voxel_begin = 0;
+    for (int k = 0; k < n; k++)
+    {
+        int i = keyed[k].second;
+        sorted[k] = i;
+        voxel_of[i] = reps.size();
+        sx += points[i].x;
+        sy += points[i].y;
+        sz += points[i].z;
+
+        if (k + 1 == n || keyed[k + 1].first != keyed[k].first)
+        {
+            int count = k + 1 - voxel_begin;
+            reps.push_back(Point3D(sx / count, sy / count, sz / count));
+            weight.push_back(count);
+            sx = sy = sz = 0;
+            voxel_begin = k + 1;
+        }
+    }
+    keyed.clear();
+    keyed.shrink_to_fit();
+
+    int m = reps.size();
+    std::cout << "  대표점 " << m << "개" << std::endl;
+
+    // 3. 대표점 가중 밀도 + 이웃 목록
+    KDTree sample_tree(reps);
+    std::vector<std::vector<int>> rep_neighbors(m);
+    std::vector<char> rep_core(m, 0);
+    parallel_for(0, m, 1024, [&](int begin, int end, int)
+                 {
+                     for (int start = begin; start < end; start += KDTREE_PACKET_SIZE)
+                     {
+                         int count = std::min(end - start, KDTREE_PACKET_SIZE);
+                         sample_tree.find_radius_packet(&reps[start], count, radius, &rep_neighbors[start]);
+
+                         for (int v = start; v < start + count; v++)
+                         {
+                             int total = 0;
+                             for (int u : rep_neighbors[v])
+                             {
+                                 total += weight[u];
+                             }
+                             rep_core[v] = total >= min_points;
+                         }
+                     }
+                 });
+
+    // 4. 대표점 DBSCAN (인덱스 순 시드, 코어만 확장)
+    std::vector<int> rep_label(m, -1);
+    std::vector<int> frontier;
+    int cluster_id = 0;
+    for (int v = 0; v < m; v++)
+    {
+        if (!rep_core[v] || rep_label[v] != -1)
+            continue;
+
+        rep_label[v] = cluster_id;
+        frontier.assign(1, v);
+        while (!frontier.empty())
+        {
+            int current = frontier.back();
+            frontier.pop_back();
+
+            for (int u : rep_neighbors[current])
+            {
+                if (rep_label[u] != -1)
+                    continue;
+
+                rep_label[u] = cluster_id;
+                if (rep_core[u])
+                    frontier.push_back(u);
+            }
+        }
+        cluster_id++;
+    }
+
+    // 5. 경계 복셀: 반경 안의 대표점 중 레이블이 다른 것이 있으면
+    std::vector<char> rep_boundary(m, 0);
+    parallel_for(0, m, 4096, [&](int begin, int end, int)
+                 {
+                     for (int v = begin; v < end; v++)
+                     {
+                         for (int u : rep_neighbors[v])
+                         {
+                             if (rep_label[u] != rep_label[v])
+                             {
+                                 rep_boundary[v] = 1;
+                                 break;
+                             }
+                         }
+                     }
+                 });
+    rep_neighbors.clear();
+    rep_neighbors.shrink_to_fit();
+
+    // 6. 대표점 레이블 전파, 경계 복셀 점은 전체 트리로 재검사
+    //    코어이거나 코어 복셀의 점이 반경 안에 있으면 그 중 가장 가까운 점의 복셀 레이블, 아니면 노이즈
+    std::vector<int> boundary;
+    for (int k = 0; k < n; k++)
+    {
+        int i = sorted[k];
+        labels[i] = rep_label[voxel_of[i]];
+        if (rep_boundary[voxel_of[i]])
+            boundary.push_back(i);
+    }
+
+    int boundary_count = boundary.size();
+    parallel_for(0, boundary_count, 4096, [&](int begin, int end, int)
+                 {
+                     Point3D targets[KDTREE_PACKET_SIZE];
+                     std::vector<int> neighbors[KDTREE_PACKET_SIZE];
+                     for (int start = begin; start < end; start += KDTREE_PACKET_SIZE)
+                     {
+                         int count = std::min(end - start, KDTREE_PACKET_SIZE);
+                         for (int q = 0; q < count; q++)
+                         {
+                             targets[q] = points[boundary[start + q]];
+                             neighbors[q].clear();
+                         }
+
+                         tree.find_radius_packet(targets, count, radius, neighbors);
+
+                         for (int q = 0; q < count; q++)
+                         {
+                             int i = boundary[start + q];
+                             const Point3D &p = targets[q];
+
+                             int best = -1;
+                             float best_d2 = 0.0f;
+                             for (int j : neighbors[q])
+                             {
+                                 int v = voxel_of[j];
+                                 if (!rep_core[v] || rep_label[v] < 0)
+                                     continue;
+
+                                 float dx = p.x - points[j].x;
+                                 float dy = p.y - points[j].y;
+                                 float dz = p.z - points[j].z;
+                                 float d2 = dx * dx + dy * dy + dz * dz;
+                                 if (best == -1 || d2 < best_d2)
+                                 {
+                                     best = v;
+                                     best_d2 = d2;
+                                 }
+                             }
+
+                             if (best != -1)
+                                 labels[i] = rep_label[best];
+                             else if ((int)neighbors[q].size() < min_points)
+                                 labels[i] = -1;
+                         }
+                     }
+                 });
+
+    if (stats)
+    {
+        stats->sample_count = m;
+        stats->boundary_points = boundary_count;
+    }
+
+    std::cout << "샘플링 DBSCAN 완료! 총 " << cluster_id << "개 클러스터, 경계 재검사 "
+              << boundary_count << "개 점" << std::endl;
+
+    return labels;
+}
+
+SampledDbscanQuality evaluate_sampled_dbscan(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    const std::vector<int> &labels,
+    float radius,
+    int min_points,
+    int reference_size)
+{
+    SampledDbscanQuality quality;
+    int n = points.size();
+    if (n == 0)
+        return quality;
+
+    // 1. 트리 순서의 가운데 구간 = 공간적으로 모인 기준 블록
+    std::vector<int> order = tree.spatial_order();
+    int size = std::min(reference_size, n);
+    int first = (n - size) / 2;
+
+    std::vector<int> block(order.begin() + first, order.begin() + first + size);
+    std::vector<Point3D> block_points(size);
+    for (int k = 0; k < size; k++)
+    {
+        block_points[k] = points[block[k]];
+    }
+
+    // 2. 블록만으로 정확 DBSCAN
+    KDTree block_tree(block_points);
+    std::vector<int> exact = dbscan_clustering_grid(block_points, block_tree, radius, min_points);
+
+    // 3. 반경 이웃 수가 전체 점군과 같은 점 = 블록 경계 영향이 없는 내부 점
+    std::vector<int> full_counts(size), block_counts(size);
+    parallel_for(0, size, 4096, [&](int begin, int end, int)
+                 {
+                     for (int start = begin; start < end; start += KDTREE_PACKET_SIZE)
+                     {
+                         int count = std::min(end - start, KDTREE_PACKET_SIZE);
+                         tree.count_radius_packet(&block_points[start], count, radius, &full_counts[start]);
+                         block_tree.count_radius_packet(&block_points[start], count, radius, &block_counts[start]);
+                     }
+                 });
+
+    // 4. 정확 클러스터 -> 가장 많이 겹치는 근사 클러스터
+    //    (블록 밖으로 이어진 클러스터는 블록 안에서 여러 조각이 되므로 정확 쪽에서 대응)
+    std::map<std::pair<int, int>, int> overlap;
+    int interior = 0, noise_match = 0;
+    for (int k = 0; k < size; k++)
+    {
+        if (full_counts[k] != block_counts[k])
+            continue;
+
+        int approx = labels[block[k]];
+        interior++;
+        if ((approx == -1) == (exact[k] == -1))
+            noise_match++;
+        if (approx != -1 && exact[k] != -1)
+            overlap[{exact[k], approx}]++;
+    }
+
+    std::map<int, std::pair<int, int>> best_match; // 정확 레이블 -> (근사 레이블, 겹치는 수)
+    for (auto &[key, count] : overlap)
+    {
+        auto it = best_match.find(key.first);
+        if (it == best_match.end() || count > it->second.second)
+            best_match[key.first] = {key.second, count};
+    }
+
+    int label_match = 0;
+    for (int k = 0; k < size; k++)
+    {
+        if (full_counts[k] != block_counts[k])
+            continue;
+
+        int approx = labels[block[k]];
+        if (exact[k] == -1)
+        {
+            label_match += approx == -1;
+        }
+        else
+        {
+            auto it = best_match.find(exact[k]);
+            label_match += it != best_match.end() && it->second.first == approx;
+        }
+    }
+
+    quality.reference_points = interior;
+    if (interior > 0)
+    {
+        quality.noise_agreement = (float)noise_match / interior;
+        quality.label_agreement = (float)label_match / interior;
+    }
+
+    std::cout << "샘플링 DBSCAN 품질: 비교 " << interior << "개 점, 노이즈 일치 "
+              << quality.noise_agreement * 100.0f << "%, 레이블 일치 "
+              << quality.label_agreement * 100.0f << "%" << std::endl;
+
+    return quality;
+}
@@ -0,0 +1,46 @@
+#ifndef SAMPLED_DBSCAN_H
+#define SAMPLED_DBSCAN_H
+
+#include <vector>
+#include "point3d.h"
+#include "kdtree.h"
+
+// 근사 DBSCAN 통계
+struct SampledDbscanStats
+{
+    int sample_count = 0;    // 복셀 대표점 수
+    int boundary_points = 0; // 클러스터 경계 근처라 정확히 재검사한 점 수
+};
+
+// 근사 DBSCAN 품질 (정확 DBSCAN과 비교)
+struct SampledDbscanQuality
+{
+    int reference_points = 0;    // 비교에 쓴 점 수 (기준 블록 내부 점)
+    float noise_agreement = 0.0f; // 노이즈 여부 일치율
+    float label_agreement = 0.0f; // 정확 클러스터를 가장 많이 겹치는 근사 클러스터로 대응시켰을 때 레이블 일치율
+};
+
+// 복셀 샘플링 근사 DBSCAN (아주 큰 점군용)
+// 1. voxel_size 격자로 다운샘플링 (대표점 = 복셀 중심, 가중치 = 점 수)
+// 2. 대표점에서 가중 DBSCAN (반경 내 가중치 합 >= min_points 이면 코어)
+// 3. 각 점은 자기 복셀 대표점의 레이블을 받음
+// 4. 이웃 대표점과 레이블이 다른 경계 복셀의 점만 tree로 정확히 재검사
+std::vector<int> dbscan_clustering_sampled(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    float radius,
+    int min_points,
+    float voxel_size,
+    SampledDbscanStats *stats = nullptr);
+
+// 공간적으로 모인 reference_size개 점 블록에서 정확 DBSCAN을 돌려 labels와 비교
+// 반경 이웃이 블록 안에 모두 있는 점만 비교 (블록 밖 연결은 반영되지 않아 실제보다 약간 낮게 나올 수 있음)
+SampledDbscanQuality evaluate_sampled_dbscan(
+    const std::vector<Point3D> &points,
+    KDTree &tree,
+    const std::vector<int> &labels,
+    float radius,
+    int min_points,
+    int reference_size = 50000);
+
+#endif // SAMPLED_DBSCAN_H
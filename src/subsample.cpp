@@ -0,0 +1,477 @@
+#include "subsample.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <thread>
+#include <unordered_map>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SUBSAMPLE_USE_SSE2
+#endif
+
+PointSubsample voxel_downsample(const std::vector<Point3D> &points, float voxel_size, bool nearest_point)
+{
+    PointSubsample result;
+    int n = points.size();
+    if (n == 0 || voxel_size <= 0)
+        return result;
+
+    std::cout << "복셀 다운샘플링 시작... (복셀 " << voxel_size << ", " << (nearest_point ? "중심에 가까운 점" : "중심")
+              << ")" << std::endl;
+
+    // 1. 복셀 키 (sampled_dbscan과 같은 21비트 x 3 키)
+    Point3D lo = points[0], hi = points[0];
+    for (const auto &p : points)
+    {
+        lo.x = std::min(lo.x, p.x);
+        lo.y = std::min(lo.y, p.y);
+        lo.z = std::min(lo.z, p.z);
+        hi.x = std::max(hi.x, p.x);
+        hi.y = std::max(hi.y, p.y);
+        hi.z = std::max(hi.z, p.z);
+    }
+
+    const double max_cells = (1 << 21) - 1;
+    double extent = std::max((double)hi.x - lo.x, std::max((double)hi.y - lo.y, (double)hi.z - lo.z));
+    double voxel = voxel_size;
+    if (extent / voxel >= max_cells)
+    {
+        voxel = extent / (max_cells - 1);
+        std::cout << "  복셀이 너무 작음 -> " << voxel << "로 확대" << std::endl;
+    }
+
+    std::vector<std::pair<uint64_t, int>> keyed(n);
+    parallel_for(0, n, 65536, [&](int begin, int end, int)
+                 {
+                     for (int i = begin; i < end; i++)
+                     {
+                         uint64_t ix = (uint64_t)((points[i].x - (double)lo.x) / voxel);
+                         uint64_t iy = (uint64_t)((points[i].y - (double)lo.y) / voxel);
+                         uint64_t iz = (uint64_t)((points[i].z - (double)lo.z) / voxel);
+                         keyed[i] = {ix << 42 | iy << 21 | iz, i};
+                     }
+                 });
+    parallel_sort(keyed);
+
+    if (task_cancelled())
+        return result;
+
+    // 2. 복셀 경계 (키가 바뀌는 위치, 직렬 한 번 훑기)
+    std::vector<int> voxel_begin;
+    for (int k = 0; k < n; k++)
+    {
+        if (k == 0 || keyed[k].first != keyed[k - 1].first)
+            voxel_begin.push_back(k);
+    }
+    int m = voxel_begin.size();
+    voxel_begin.push_back(n);
+
+    // 3. 복셀별 중심 (+ 가장 가까운 점), owner는 복셀마다 자기 구간만 쓰므로 병렬로 기록
+    result.points.resize(m);
+    result.source.assign(m, -1);
+    result.owner.resize(n);
+    parallel_for(0, m, 4096, [&](int begin, int end, int)
+                 {
+                     for (int v = begin; v < end; v++)
+                     {
+                         double sx = 0, sy = 0, sz = 0;
+                         for (int k = voxel_begin[v]; k < voxel_begin[v + 1]; k++)
+                         {
+                             const Point3D &p = points[keyed[k].second];
+                             sx += p.x;
+                             sy += p.y;
+                             sz += p.z;
+                             result.owner[keyed[k].second] = v;
+                         }
+                         int count = voxel_begin[v + 1] - voxel_begin[v];
+                         Point3D center(sx / count, sy / count, sz / count);
+
+                         if (!nearest_point)
+                         {
+                             result.points[v] = center;
+                             continue;
+                         }
+
+                         // 같은 거리면 원본 인덱스가 작은 점 (키 정렬에서 같은 키는 인덱스 순)
+                         int best = -1;
+                         float best_dist = std::numeric_limits<float>::max();
+                         for (int k = voxel_begin[v]; k < voxel_begin[v + 1]; k++)
+                         {
+                             const Point3D &p = points[keyed[k].second];
+                             float dx = p.x - center.x, dy = p.y - center.y, dz = p.z - center.z;
+                             float dist = dx * dx + dy * dy + dz * dz;
+                             if (dist < best_dist)
+                             {
+                                 best_dist = dist;
+                                 best = keyed[k].second;
+                             }
+                         }
+                         result.points[v] = points[best];
+                         result.source[v] = best;
+                     }
+                 });
+
+    std::cout << "복셀 다운샘플링 완료! " << n << " -> " << m << "개" << std::endl;
+    return result;
+}
+
+// ==================== 가장 먼 점 샘플링 ====================
+
+// 구간 최댓값 후보 (거리는 제곱 거리)
+struct FarthestCandidate
+{
+    float distance = -1.0f;
+    int index = -1;
+};
+
+// 같은 거리면 인덱스가 작은 쪽 (스레드 수와 관계없이 같은 결과)
+static bool farther(const FarthestCandidate &a, const FarthestCandidate &b)
+{
+    return a.distance > b.distance || (a.distance == b.distance && a.index >= 0 && (b.index < 0 || a.index < b.index));
+}
+
+// [begin, end) (4의 배수 경계)의 최소 거리를 점 p까지의 거리로 갱신하면서 최댓값 위치를 찾음
+// 이미 고른 점과 패딩 칸은 최소 거리가 -1이라 고르지 않음
+static FarthestCandidate update_min_distances(const float *xs, const float *ys, const float *zs, float *min_d2,
+                                              int begin, int end, const Point3D &p)
+{
+    FarthestCandidate best;
+#ifdef SUBSAMPLE_USE_SSE2
+    __m128 px = _mm_set1_ps(p.x);
+    __m128 py = _mm_set1_ps(p.y);
+    __m128 pz = _mm_set1_ps(p.z);
+    __m128 best_d = _mm_set1_ps(-1.0f);
+    __m128i best_i = _mm_set1_epi32(-1);
+    __m128i index = _mm_setr_epi32(begin, begin + 1, begin + 2, begin + 3);
+    const __m128i four = _mm_set1_epi32(4);
+    for (int i = begin; i < end; i += 4)
+    {
+        __m128 dx = _mm_sub_ps(_mm_load_ps(xs + i), px);
+        __m128 dy = _mm_sub_ps(_mm_load_ps(ys + i), py);
+        __m128 dz = _mm_sub_ps(_mm_load_ps(zs + i), pz);
+        __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        __m128 m = _mm_min_ps(_mm_load_ps(min_d2 + i), d2);
+        _mm_store_ps(min_d2 + i, m);
+
+        // 칸별로 더 클 때만 교체 -> 같은 값이면 앞 인덱스 유지
+        __m128i greater = _mm_castps_si128(_mm_cmpgt_ps(m, best_d));
+        best_d = _mm_max_ps(best_d, m);
+        best_i = _mm_or_si128(_mm_and_si128(greater, index), _mm_andnot_si128(greater, best_i));
+        index = _mm_add_epi32(index, four);
+    }
+
+    alignas(16) float lane_d[4];
+    alignas(16) int lane_i[4];
+    _mm_store_ps(lane_d, best_d);
+    _mm_store_si128((__m128i *)lane_i, best_i);
+    for (int k = 0; k < 4; k++)
+    {
+        FarthestCandidate lane;
+        lane.distance = lane_d[k];
+        lane.index = lane_i[k];
+        if (farther(lane, best))
+            best = lane;
+    }
+#else
+    for (int i = begin; i < end; i++)
+    {
+        float dx = xs[i] - p.x;
+        float dy = ys[i] - p.y;
+        float dz = zs[i] - p.z;
+        float m = std::min(min_d2[i], dx * dx + dy * dy + dz * dz);
+        min_d2[i] = m;
+        if (m > best.distance)
+        {
+            best.distance = m;
+            best.index = i;
+        }
+    }
+#endif
+    return best;
+}
+
+// 반복마다 스레드를 새로 만들지 않도록 구간을 맡은 스레드들이 반복 사이에 기다리는 장벽
+class SpinBarrier
+{
+public:
+    explicit SpinBarrier(int count) : count(count) {}
+
+    void wait()
+    {
+        int gen = generation.load();
+        if (waiting.fetch_add(1) + 1 == count)
+        {
+            waiting.store(0);
+            generation.fetch_add(1);
+            return;
+        }
+        while (generation.load() == gen)
+            std::this_thread::yield();
+    }
+
+private:
+    int count;
+    std::atomic<int> waiting{0};
+    std::atomic<int> generation{0};
+};
+
+std::vector<int> farthest_point_sample(const std::vector<Point3D> &points, int count, int start_index)
+{
+    std::vector<int> result;
+    int n = points.size();
+    if (n == 0 || count <= 0)
+        return result;
+    count = std::min(count, n);
+    start_index = std::clamp(start_index, 0, n - 1);
+
+    std::cout << "가장 먼 점 샘플링 시작... (" << count << "개)" << std::endl;
+
+    // SoA + 4의 배수 패딩 (패딩 칸은 최소 거리 -1)
+    int padded = (n + 3) & ~3;
+    struct alignas(16) Lane
+    {
+        float v[4];
+    };
+    std::vector<Lane> storage(4 * (padded / 4));
+    float *xs = storage[0].v;
+    float *ys = xs + padded;
+    float *zs = ys + padded;
+    float *min_d2 = zs + padded;
+    for (int i = 0; i < padded; i++)
+    {
+        xs[i] = i < n ? points[i].x : 0.0f;
+        ys[i] = i < n ? points[i].y : 0.0f;
+        zs[i] = i < n ? points[i].z : 0.0f;
+        min_d2[i] = i < n ? std::numeric_limits<float>::max() : -1.0f;
+    }
+
+    // 스레드별 고정 구간 (반복마다 같은 구간이라 캐시에 남음)
+    int threads = std::min(worker_count(), std::max(n / 65536, 1));
+    int slice = ((padded / threads) + 3) & ~3;
+    std::vector<FarthestCandidate> slice_best(threads);
+
+    int selected = start_index;
+    bool stop = false;
+    result.reserve(count);
+    result.push_back(selected);
+    min_d2[selected] = -1.0f;
+    task_begin_stage(count);
+
+    auto update_slice = [&](int t)
+    {
+        int begin = std::min(padded, t * slice);
+        int end = t + 1 == threads ? padded : std::min(padded, (t + 1) * slice);
+        slice_best[t] = update_min_distances(xs, ys, zs, min_d2, begin, end, points[selected]);
+    };
+
+    // 구간 최댓값을 합쳐 다음 점 선택 (스레드 0만 실행)
+    auto select_next = [&]()
+    {
+        FarthestCandidate best;
+        for (const FarthestCandidate &c : slice_best)
+        {
+            if (farther(c, best))
+                best = c;
+        }
+
+        if (task_cancelled() || best.index < 0)
+        {
+            stop = true;
+            return;
+        }
+        selected = best.index;
+        min_d2[selected] = -1.0f;
+        result.push_back(selected);
+        task_set_progress(result.size());
+        stop = (int)result.size() >= count;
+    };
+
+    if (count > 1)
+    {
+        if (threads <= 1)
+        {
+            while (!stop)
+            {
+                update_slice(0);
+                select_next();
+            }
+        }
+        else
+        {
+            // 갱신 -> 장벽 -> 스레드 0이 선택 -> 장벽
+            SpinBarrier barrier(threads);
+            std::vector<std::thread> pool;
+            for (int t = 1; t < threads; t++)
+            {
+                pool.emplace_back([&, t]()
+                                  {
+                                      for (;;)
+                                      {
+                                          update_slice(t);
+                                          barrier.wait();
+                                          barrier.wait();
+                                          if (stop)
+                                              break;
+                                      } });
+            }
+            for (;;)
+            {
+                update_slice(0);
+                barrier.wait();
+                select_next();
+                barrier.wait();
+                if (stop)
+                    break;
+            }
+            for (auto &th : pool)
+            {
+                th.join();
+            }
+        }
+    }
+
+    std::cout << "가장 먼 점 샘플링 완료! " << result.size() << "개 (스레드 " << threads << "개)" << std::endl;
+    return result;
+}
+
+// ==================== 포아송 디스크 샘플링 ====================
+
+std::vector<int> poisson_disk_sample(const std::vector<Point3D> &points, float min_spacing, unsigned seed)
+{
+    std::vector<int> result;
+    int n = points.size();
+    if (n == 0 || min_spacing <= 0)
+        return result;
+
+    std::cout << "포아송 디스크 샘플링 시작... (최소 간격 " << min_spacing << ")" << std::endl;
+
+    Point3D lo = points[0], hi = points[0];
+    for (const auto &p : points)
+    {
+        lo.x = std::min(lo.x, p.x);
+        lo.y = std::min(lo.y, p.y);
+        lo.z = std::min(lo.z, p.z);
+        hi.x = std::max(hi.x, p.x);
+        hi.y = std::max(hi.y, p.y);
+        hi.z = std::max(hi.z, p.z);
+    }
+
+    // 셀 대각선 = 최소 간격 -> 같은 셀의 두 점은 항상 최소 간격 안
+    const double max_cells = (1 << 21) - 1;
+    double extent = std::max((double)hi.x - lo.x, std::max((double)hi.y - lo.y, (double)hi.z - lo.z));
+    double spacing = min_spacing;
+    double cell = spacing / std::sqrt(3.0);
+    if (extent / cell >= max_cells)
+    {
+        cell = extent / (max_cells - 1);
+        spacing = cell * std::sqrt(3.0);
+        std::cout << "  간격이 너무 작음 -> " << spacing << "로 확대" << std::endl;
+    }
+    const float spacing_sq = spacing * spacing;
+
+    // 1. 점별 셀 키
+    std::vector<uint64_t> key_of(n);
+    parallel_for(0, n, 65536, [&](int begin, int end, int)
+                 {
+                     for (int i = begin; i < end; i++)
+                     {
+                         uint64_t ix = (uint64_t)((points[i].x - (double)lo.x) / cell);
+                         uint64_t iy = (uint64_t)((points[i].y - (double)lo.y) / cell);
+                         uint64_t iz = (uint64_t)((points[i].z - (double)lo.z) / cell);
+                         key_of[i] = ix << 42 | iy << 21 | iz;
+                     }
+                 });
+
+    // 2. 셀별 채택된 샘플 (키 -> 원본 인덱스)
+    std::unordered_map<uint64_t, int> cell_sample;
+    cell_sample.reserve(n / 4 + 16);
+
+    // 3. 무작위 순서로 채택 (자기 셀에 샘플이 있으면 바로 기각, 비어 있으면 ±2 셀 확인)
+    std::vector<int> order(n);
+    for (int i = 0; i < n; i++)
+        order[i] = i;
+    std::mt19937 rng(seed);
+    std::shuffle(order.begin(), order.end(), rng);
+
+    const uint64_t axis_mask = (1 << 21) - 1;
+    task_begin_stage(n);
+    for (int k = 0; k < n; k++)
+    {
+        if (k % 65536 == 0)
+        {
+            task_set_progress(k);
+            if (task_cancelled())
+                return result;
+        }
+
+        int i = order[k];
+        uint64_t key = key_of[i];
+        if (cell_sample.count(key))
+            continue;
+
+        long long cx = key >> 42, cy = (key >> 21) & axis_mask, cz = key & axis_mask;
+        const Point3D &p = points[i];
+        bool accept = true;
+        for (long long dx = -2; dx <= 2 && accept; dx++)
+        {
+            for (long long dy = -2; dy <= 2 && accept; dy++)
+            {
+                for (long long dz = -2; dz <= 2 && accept; dz++)
+                {
+                    long long x = cx + dx, y = cy + dy, z = cz + dz;
+                    if (x < 0 || y < 0 || z < 0 || x > (long long)axis_mask || y > (long long)axis_mask ||
+                        z > (long long)axis_mask)
+                        continue;
+
+                    auto it = cell_sample.find((uint64_t)x << 42 | (uint64_t)y << 21 | (uint64_t)z);
+                    if (it == cell_sample.end())
+                        continue;
+
+                    const Point3D &q = points[it->second];
+                    float ex = p.x - q.x, ey = p.y - q.y, ez = p.z - q.z;
+                    if (ex * ex + ey * ey + ez * ez < spacing_sq)
+                        accept = false;
+                }
+            }
+        }
+
+        if (accept)
+        {
+            cell_sample[key] = i;
+            result.push_back(i);
+        }
+    }
+
+    std::cout << "포아송 디스크 샘플링 완료! " << n << " -> " << result.size() << "개" << std::endl;
+    return result;
+}
+
+PointSubsample make_index_subsample(const std::vector<Point3D> &points, const std::vector<int> &indices)
+{
+    PointSubsample result;
+    result.owner.assign(points.size(), -1);
+    result.points.reserve(indices.size());
+    result.source = indices;
+    for (size_t k = 0; k < indices.size(); k++)
+    {
+        result.points.push_back(points[indices[k]]);
+        result.owner[indices[k]] = k;
+    }
+    return result;
+}
+
+std::vector<bool> expand_subsample_mask(const PointSubsample &subsample, const std::vector<bool> &mask)
+{
+    std::vector<bool> expanded(subsample.owner.size(), false);
+    for (size_t i = 0; i < subsample.owner.size(); i++)
+    {
+        int v = subsample.owner[i];
+        expanded[i] = v >= 0 && mask[v];
+    }
+    return expanded;
+}
@@ -0,0 +1,43 @@
+#ifndef SUBSAMPLE_H
+#define SUBSAMPLE_H
+
+#include <vector>
+#include "point3d.h"
+
+// 축소한 점군과 원본 점의 대응
+// 축소 점군에서 구한 마스크/레이블을 expand_subsample_mask로 원본 해상도에 되돌림
+struct PointSubsample
+{
+    std::vector<Point3D> points; // 축소된 점
+    std::vector<int> source;     // 축소 점별 원본 인덱스 (복셀 중심처럼 원본 점이 아니면 -1)
+    std::vector<int> owner;      // 원본 인덱스 -> 축소 점 번호 (대응하는 축소 점이 없으면 -1)
+
+    bool empty() const { return points.empty(); }
+};
+
+// 복셀 격자 다운샘플링 (복셀마다 점 하나)
+// 복셀 키를 병렬로 계산해 병렬 정렬한 뒤 같은 키 구간을 복셀 하나로 묶음 (키 한 축 21비트, 넘치면 복셀 확대)
+// nearest_point = false: 복셀 점 = 복셀 안 점들의 중심 (source = -1)
+// nearest_point = true : 복셀 점 = 중심에 가장 가까운 원본 점 (source = 그 점의 인덱스)
+// 복셀 번호는 키 순서라 공간적으로 모여 있음, 모든 원본 점의 owner는 자기 복셀
+PointSubsample voxel_downsample(const std::vector<Point3D> &points, float voxel_size, bool nearest_point);
+
+// 가장 먼 점 샘플링 (Farthest Point Sampling)
+// start_index에서 시작해 매번 이미 고른 점들까지의 최소 거리가 가장 큰 점을 고름 (같으면 인덱스가 작은 점)
+// 점별 최소 거리 배열을 스레드별 구간으로 나눠 새 점과의 거리로 갱신하면서 SIMD로 최댓값 위치를 찾음
+// 반환: 고른 순서대로 원본 인덱스 (count가 점 수보다 크면 전체)
+std::vector<int> farthest_point_sample(const std::vector<Point3D> &points, int count, int start_index = 0);
+
+// 포아송 디스크 샘플링: 서로 min_spacing 이상 떨어진 점만 남김
+// 격자 셀 한 변 = min_spacing/√3이라 셀마다 샘플은 최대 하나
+// 점을 고정 시드 무작위 순서로 훑으며 자기 셀이 비어 있고 주변 셀(±2)의 샘플과 min_spacing 이상 떨어져 있으면 채택
+// 반환: 원본 인덱스 (채택 순서)
+std::vector<int> poisson_disk_sample(const std::vector<Point3D> &points, float min_spacing, unsigned seed = 1);
+
+// 원본 인덱스 목록 -> PointSubsample (목록에 없는 원본 점의 owner는 -1)
+PointSubsample make_index_subsample(const std::vector<Point3D> &points, const std::vector<int> &indices);
+
+// 축소 점 마스크 -> 원본 점 마스크 (owner가 true인 축소 점인 원본 점만 true)
+std::vector<bool> expand_subsample_mask(const PointSubsample &subsample, const std::vector<bool> &mask);
+
+#endif // SUBSAMPLE_H
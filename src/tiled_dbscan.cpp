@@ -0,0 +1,850 @@
+#include "tiled_dbscan.h"
+#include "clustering.h"
+#include "kdtree.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// 타일 임시 파일의 점 레코드
+struct TilePoint
+{
+    uint64_t id; // 파일 안의 정점 번호
+    float x, y, z;
+};
+
+// halo 점과 반경 안에 있는 코어 점의 지역 클러스터 (halo 점의 소유 타일로 전달)
+struct HaloLink
+{
+    uint64_t id;
+    int tile;  // 링크를 만든 타일
+    int label; // 그 타일의 지역 클러스터 번호
+};
+
+// 타일 경계 근처의 소유 점 (병합 시 halo 링크 조회용)
+struct BorderPoint
+{
+    uint64_t id;
+    int label;
+    int core;
+};
+
+// 소유 타일에서 노이즈였지만 다른 타일 코어의 경계점으로 배정된 점 (타일별 파일에 id 순서로 저장)
+struct BorderAssign
+{
+    uint64_t id;
+    int cluster; // 전역 클러스터 (union-find 전 번호)
+};
+
+// 타일 사각형 (XZ), 예산을 넘어 나눈 타일은 자식 두 개를 가짐
+struct TileRect
+{
+    double x0, x1, z0, z1;
+    int axis = -1;      // 나눈 축 (0: X, 1: Z), 잎 타일이면 -1
+    double split = 0.0; // 나눈 위치 (좌표 >= split이면 두 번째 자식)
+    int child = -1;     // 첫 번째 자식 번호 (두 번째는 child + 1)
+};
+
+// XZ 평면 타일 격자
+struct TileGrid
+{
+    double lo_x, lo_z;
+    double width_x, width_z;
+    int nx, nz;
+    double halo;
+    std::vector<TileRect> rects; // 0 ~ nx * nz - 1: 격자 타일, 그 뒤: 나눠서 생긴 타일
+
+    void init_rects()
+    {
+        rects.clear();
+        for (int tz = 0; tz < nz; tz++)
+            for (int tx = 0; tx < nx; tx++)
+            {
+                TileRect r;
+                r.x0 = lo_x + tx * width_x;
+                r.x1 = r.x0 + width_x;
+                r.z0 = lo_z + tz * width_z;
+                r.z1 = r.z0 + width_z;
+                rects.push_back(r);
+            }
+    }
+
+    int tile_of(const Point3D &p) const
+    {
+        int tx = std::min(nx - 1, std::max(0, (int)((p.x - lo_x) / width_x)));
+        int tz = std::min(nz - 1, std::max(0, (int)((p.z - lo_z) / width_z)));
+        return tz * nx + tx;
+    }
+
+    // p가 tile에서 (dx, dz) 방향 이웃 타일의 halo 안에 있는지
+    bool near_side(const Point3D &p, int tile, int dx, int dz) const
+    {
+        int tx = tile % nx + dx, tz = tile / nx + dz;
+        if (tx < 0 || tx >= nx || tz < 0 || tz >= nz)
+            return false;
+
+        double x0 = lo_x + (tile % nx) * width_x, x1 = x0 + width_x;
+        double z0 = lo_z + (tile / nx) * width_z, z1 = z0 + width_z;
+        if (dx < 0 && p.x - x0 > halo)
+            return false;
+        if (dx > 0 && x1 - p.x > halo)
+            return false;
+        if (dz < 0 && p.z - z0 > halo)
+            return false;
+        if (dz > 0 && z1 - p.z > halo)
+            return false;
+        return true;
+    }
+
+    // p를 소유한 잎 타일
+    int leaf_of(const Point3D &p) const
+    {
+        int t = tile_of(p);
+        while (rects[t].child >= 0)
+        {
+            const TileRect &r = rects[t];
+            t = r.child + ((r.axis == 0 ? p.x : p.z) >= r.split ? 1 : 0);
+        }
+        return t;
+    }
+
+    // p가 tile을 halo만큼 넓힌 범위 안에 있는지 (tile의 DBSCAN에 필요한 점)
+    bool in_reach(const Point3D &p, int tile) const
+    {
+        const TileRect &r = rects[tile];
+        return p.x >= r.x0 - halo && p.x <= r.x1 + halo && p.z >= r.z0 - halo && p.z <= r.z1 + halo;
+    }
+
+    // tile이 소유한 p가 경계에서 halo 폭 안에 있는지 (다른 타일의 halo에 들어갈 수 있는 점)
+    bool near_border(const Point3D &p, int tile) const
+    {
+        const TileRect &r = rects[tile];
+        return p.x - r.x0 <= halo || r.x1 - p.x <= halo || p.z - r.z0 <= halo || r.z1 - p.z <= halo;
+    }
+};
+
+static fs::path tile_file(const fs::path &dir, const char *kind, int tile)
+{
+    return dir / (std::string(kind) + "_" + std::to_string(tile) + ".bin");
+}
+
+// 타일별 임시 파일에 레코드 추가
+// 타일 수만큼 파일을 열어 두지 않도록 메모리에 모았다가 전체가 buffer_bytes를 넘으면 파일마다 열어 붙여 쓰고 닫음
+struct TileWriter
+{
+    fs::path dir;
+    const char *kind;
+    size_t limit;
+    size_t buffered = 0;
+    std::vector<std::vector<char>> buffers;
+
+    TileWriter(const fs::path &dir, const char *kind, size_t buffer_bytes) : dir(dir), kind(kind), limit(buffer_bytes) {}
+    ~TileWriter() { flush(); }
+
+    void write(int tile, const void *record, size_t size)
+    {
+        if (tile >= (int)buffers.size())
+            buffers.resize(tile + 1);
+
+        const char *bytes = static_cast<const char *>(record);
+        buffers[tile].insert(buffers[tile].end(), bytes, bytes + size);
+        buffered += size;
+        if (buffered >= limit)
+            flush();
+    }
+
+    void flush()
+    {
+        for (int t = 0; t < (int)buffers.size(); t++)
+        {
+            if (buffers[t].empty())
+                continue;
+
+            std::ofstream out(tile_file(dir, kind, t), std::ios::binary | std::ios::app);
+            out.write(buffers[t].data(), buffers[t].size());
+            std::vector<char>().swap(buffers[t]);
+        }
+        buffered = 0;
+    }
+};
+
+// 타일별 임시 파일의 레코드를 앞에서부터 차례로 읽음 (필요할 때만 열어 chunk개씩 읽고 닫음)
+template <typename T>
+struct TileReader
+{
+    fs::path dir;
+    const char *kind;
+    size_t chunk;
+    std::vector<std::vector<T>> buffers;
+    std::vector<size_t> next;     // 버퍼에서 다음에 읽을 위치
+    std::vector<long long> offset; // 파일에서 다음에 읽을 레코드 번호
+
+    TileReader(const fs::path &dir, const char *kind, int tile_count, size_t buffer_bytes)
+        : dir(dir), kind(kind), buffers(tile_count), next(tile_count, 0), offset(tile_count, 0)
+    {
+        chunk = std::clamp<size_t>(buffer_bytes / sizeof(T) / std::max(tile_count, 1), 256, 65536);
+    }
+
+    bool read(int tile, T &record)
+    {
+        std::vector<T> &buffer = buffers[tile];
+        if (next[tile] == buffer.size())
+        {
+            buffer.resize(chunk);
+            std::ifstream in(tile_file(dir, kind, tile), std::ios::binary);
+            in.seekg(offset[tile] * sizeof(T));
+            in.read(reinterpret_cast<char *>(buffer.data()), chunk * sizeof(T));
+            buffer.resize(in.gcount() / sizeof(T));
+            offset[tile] += buffer.size();
+            next[tile] = 0;
+            if (buffer.empty())
+                return false;
+        }
+
+        record = buffer[next[tile]++];
+        return true;
+    }
+};
+
+// "v x y z ..." 줄에서 좌표 읽기 (vn, vt 줄은 제외)
+static bool parse_vertex(const std::string &line, Point3D &p)
+{
+    if (line.size() < 2 || line[0] != 'v' || (line[1] != ' ' && line[1] != '\t'))
+        return false;
+
+    const char *s = line.c_str() + 2;
+    char *end;
+    p.x = std::strtof(s, &end);
+    p.y = std::strtof(end, &end);
+    p.z = std::strtof(end, &end);
+    return true;
+}
+
+static int find_root(std::vector<int> &parent, int x)
+{
+    while (parent[x] != x)
+    {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+template <typename T>
+static std::vector<T> read_records(const fs::path &path)
+{
+    std::vector<T> records;
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return records;
+
+    file.seekg(0, std::ios::end);
+    records.resize((size_t)file.tellg() / sizeof(T));
+    file.seekg(0, std::ios::beg);
+    file.read(reinterpret_cast<char *>(records.data()), records.size() * sizeof(T));
+    return records;
+}
+
+// 파일을 줄 단위로 훑는 단계의 진행률(파일 위치)과 취소 확인 (줄 65536개마다, 취소되면 true)
+static bool file_pass_cancelled(std::ifstream &in, long long &lines)
+{
+    if (++lines % 65536 != 0)
+        return false;
+    task_set_progress(in.tellg());
+    return task_cancelled();
+}
+
+bool dbscan_clustering_tiled(
+    const std::string &obj_path,
+    const std::string &label_path,
+    const std::string &largest_path,
+    float radius,
+    int min_points,
+    size_t memory_budget_mb,
+    TiledDbscanStats *stats)
+{
+    std::cout << "타일 DBSCAN 시작: " << obj_path << " (메모리 예산 " << memory_budget_mb << " MB)" << std::endl;
+
+    // 1. 범위와 정점 수 (스트리밍)
+    std::ifstream in(obj_path);
+    if (!in.is_open())
+    {
+        std::cerr << "파일 열기 실패: " << obj_path << std::endl;
+        return false;
+    }
+
+    std::error_code ec;
+    long long file_bytes = fs::file_size(obj_path, ec);
+    long long lines = 0;
+
+    std::string line;
+    Point3D p;
+    long long count = 0;
+    Point3D lo, hi;
+    std::vector<Point3D> sample;
+    std::mt19937_64 rng(12345);
+    task_begin_stage(file_bytes);
+    while (std::getline(in, line))
+    {
+        if (file_pass_cancelled(in, lines))
+            return false;
+        if (!parse_vertex(line, p))
+            continue;
+
+        if (count == 0)
+        {
+            lo = hi = p;
+        }
+
+        // reservoir sampling: 지금까지 읽은 점 중 균일한 표본 유지
+        if ((long long)sample.size() < TILED_SAMPLE_SIZE)
+        {
+            sample.push_back(p);
+        }
+        else
+        {
+            long long slot = std::uniform_int_distribution<long long>(0, count)(rng);
+            if (slot < TILED_SAMPLE_SIZE)
+                sample[slot] = p;
+        }
+
+        lo.x = std::min(lo.x, p.x);
+        lo.z = std::min(lo.z, p.z);
+        hi.x = std::max(hi.x, p.x);
+        hi.z = std::max(hi.z, p.z);
+        count++;
+    }
+
+    if (count == 0)
+    {
+        std::cerr << "정점이 없음: " << obj_path << std::endl;
+        return false;
+    }
+
+    // 2. 타일 격자: 표본으로 추정한 평균 타일(halo 포함)이 예산의 절반 안에 드는 가장 적은 타일 수
+    //    밀도가 고르지 않으면 격자 전체를 잘게 나누는 대신 예산을 넘는 타일만 3-1에서 나눔
+    //    타일 폭은 2 * radius 이상 -> halo는 바로 옆 타일까지만 닿음
+    size_t budget_points = std::max<size_t>(1, memory_budget_mb * 1024 * 1024 / TILED_BYTES_PER_POINT);
+    double extent_x = (double)hi.x - lo.x, extent_z = (double)hi.z - lo.z;
+    int max_nx = std::max(1, (int)std::min(extent_x / (2.0 * radius), 65536.0));
+    int max_nz = std::max(1, (int)std::min(extent_z / (2.0 * radius), 65536.0));
+
+    TileGrid grid;
+    grid.lo_x = lo.x;
+    grid.lo_z = lo.z;
+    grid.halo = radius * (1.0 + 1e-4); // float 반올림 여유
+    for (int k = 1;; k++)
+    {
+        grid.nx = std::min(k, max_nx);
+        grid.nz = std::min(k, max_nz);
+        grid.width_x = extent_x > 0 ? extent_x / grid.nx : 1.0;
+        grid.width_z = extent_z > 0 ? extent_z / grid.nz : 1.0;
+        if (grid.nx == max_nx && grid.nz == max_nz)
+            break;
+
+        long long copies = 0; // 표본 점이 들어가는 타일 수 합 (halo 복사 포함)
+        for (const Point3D &s : sample)
+        {
+            int t = grid.tile_of(s);
+            copies++;
+            for (int dz = -1; dz <= 1; dz++)
+                for (int dx = -1; dx <= 1; dx++)
+                    if ((dx != 0 || dz != 0) && grid.near_side(s, t, dx, dz))
+                        copies++;
+        }
+
+        double estimate = (double)copies / (grid.nx * grid.nz) * count / sample.size();
+        if (estimate * 2.0 <= budget_points)
+            break;
+    }
+    grid.init_rects();
+    sample.clear();
+    sample.shrink_to_fit();
+
+    std::cout << "  정점 " << count << "개, 타일 " << grid.nx << " x " << grid.nz << std::endl;
+
+    // 임시 파일은 붙여 쓰므로 이전 실행이 남긴 파일을 먼저 지움
+    fs::path label_file(label_path);
+    fs::path tmp = label_file.parent_path() / (label_file.stem().string() + "_tiles");
+    fs::remove_all(tmp, ec);
+    fs::create_directories(tmp, ec);
+    if (ec)
+    {
+        std::cerr << "임시 폴더 생성 실패: " << tmp.string() << std::endl;
+        return false;
+    }
+
+    // 3. 점을 타일 파일로 분배 (halo 폭 안이면 이웃 타일에도 복사)
+    //    백그라운드 작업이 취소되면 임시 파일을 지우고 중단 (단계마다 같음)
+    bool cancelled = false;
+    {
+        TileWriter tile_out(tmp, "tile", TILED_IO_BUFFER_BYTES);
+
+        in.clear();
+        in.seekg(0);
+        uint64_t id = 0;
+        lines = 0;
+        task_begin_stage(file_bytes);
+        while (std::getline(in, line))
+        {
+            if (file_pass_cancelled(in, lines))
+            {
+                cancelled = true;
+                break;
+            }
+            if (!parse_vertex(line, p))
+                continue;
+
+            TilePoint tp = {id++, p.x, p.y, p.z};
+            int owner = grid.tile_of(p);
+            tile_out.write(owner, &tp, sizeof(tp));
+
+            for (int dz = -1; dz <= 1; dz++)
+                for (int dx = -1; dx <= 1; dx++)
+                {
+                    if ((dx != 0 || dz != 0) && grid.near_side(p, owner, dx, dz))
+                        tile_out.write(owner + dz * grid.nx + dx, &tp, sizeof(tp));
+                }
+        }
+    }
+
+    // 3-1. 표본 추정이 빗나가 예산을 넘은 타일은 긴 축으로 반씩 나눔
+    //      부모 파일에는 부모를 halo만큼 넓힌 범위의 점이 모두 있으므로 스트리밍으로 읽어 두 자식의 범위에 든 점만 씀
+    std::vector<int> pending;
+    for (int t = grid.nx * grid.nz - 1; t >= 0 && !cancelled; t--)
+    {
+        pending.push_back(t);
+    }
+    while (!pending.empty())
+    {
+        if (task_cancelled())
+        {
+            cancelled = true;
+            break;
+        }
+
+        int t = pending.back();
+        pending.pop_back();
+
+        uintmax_t bytes = fs::file_size(tile_file(tmp, "tile", t), ec);
+        if (ec || bytes / sizeof(TilePoint) <= budget_points)
+            continue;
+
+        // 폭이 반경보다 좁으면 자식도 대부분 halo라 점 수가 거의 줄지 않음 (반경 하나 안에 점이 몰린 경우)
+        TileRect r = grid.rects[t];
+        int axis = r.x1 - r.x0 >= r.z1 - r.z0 ? 0 : 1;
+        double width = axis == 0 ? r.x1 - r.x0 : r.z1 - r.z0;
+        if (width < radius)
+        {
+            std::cout << "  타일 " << t << "의 점 " << bytes / sizeof(TilePoint) << "개가 예산(" << budget_points
+                      << "개)을 넘지만 폭이 반경보다 좁아 더 나누지 않음" << std::endl;
+            continue;
+        }
+
+        int child = grid.rects.size();
+        TileRect first = r, second = r;
+        double split = axis == 0 ? (r.x0 + r.x1) * 0.5 : (r.z0 + r.z1) * 0.5;
+        if (axis == 0)
+            first.x1 = second.x0 = split;
+        else
+            first.z1 = second.z0 = split;
+        grid.rects[t].axis = axis;
+        grid.rects[t].split = split;
+        grid.rects[t].child = child;
+        grid.rects.push_back(first);
+        grid.rects.push_back(second);
+
+        {
+            std::ifstream parent_in(tile_file(tmp, "tile", t), std::ios::binary);
+            std::ofstream first_out(tile_file(tmp, "tile", child), std::ios::binary);
+            std::ofstream second_out(tile_file(tmp, "tile", child + 1), std::ios::binary);
+            std::vector<TilePoint> chunk(65536);
+            for (;;)
+            {
+                parent_in.read(reinterpret_cast<char *>(chunk.data()), chunk.size() * sizeof(TilePoint));
+                size_t got = parent_in.gcount() / sizeof(TilePoint);
+                if (got == 0)
+                    break;
+
+                for (size_t k = 0; k < got; k++)
+                {
+                    const TilePoint &tp = chunk[k];
+                    Point3D q(tp.x, tp.y, tp.z);
+                    if (grid.in_reach(q, child))
+                        first_out.write(reinterpret_cast<const char *>(&tp), sizeof(tp));
+                    if (grid.in_reach(q, child + 1))
+                        second_out.write(reinterpret_cast<const char *>(&tp), sizeof(tp));
+                }
+            }
+        }
+        fs::remove(tile_file(tmp, "tile", t), ec);
+
+        pending.push_back(child + 1);
+        pending.push_back(child);
+    }
+
+    int tile_count = grid.rects.size();
+    int leaf_count = 0;
+    for (const TileRect &r : grid.rects)
+    {
+        if (r.child < 0)
+            leaf_count++;
+    }
+    if (cancelled || task_cancelled())
+    {
+        fs::remove_all(tmp, ec);
+        return false;
+    }
+    if (leaf_count > grid.nx * grid.nz)
+    {
+        std::cout << "  예산을 넘은 타일을 나눠 타일 " << leaf_count << "개" << std::endl;
+    }
+
+    // 4. 타일별 DBSCAN (한 번에 타일 하나, 타일 안에서는 병렬)
+    //    나눈 타일(잎이 아닌 타일)은 점이 없고 클러스터 수는 0
+    std::vector<int> cluster_base(tile_count + 1, 0);
+    long long max_tile_points = 0;
+    {
+        TileWriter halo_out(tmp, "halo", TILED_IO_BUFFER_BYTES);
+
+        // 진행률은 타일 단위 (타일 안의 parallel_for는 단계를 바꾸지 않음)
+        int leaves_done = 0;
+        task_begin_stage(leaf_count);
+        task_hold_stage(true);
+        for (int t = 0; t < tile_count; t++)
+        {
+            if (grid.rects[t].child >= 0)
+                continue;
+
+            task_set_progress(leaves_done++);
+            if (task_cancelled())
+            {
+                cancelled = true;
+                break;
+            }
+
+            std::vector<TilePoint> tile = read_records<TilePoint>(tile_file(tmp, "tile", t));
+            fs::remove(tile_file(tmp, "tile", t), ec);
+
+            int n = tile.size();
+            max_tile_points = std::max(max_tile_points, (long long)n);
+
+            std::vector<Point3D> points(n);
+            std::vector<int> owner(n); // 점을 소유한 잎 타일
+            for (int i = 0; i < n; i++)
+            {
+                points[i] = Point3D(tile[i].x, tile[i].y, tile[i].z);
+                owner[i] = grid.leaf_of(points[i]);
+            }
+
+            std::vector<int> labels;
+            if (n > 0)
+            {
+                KDTree tree(points, true);
+                tree.build_all();
+                labels = dbscan_clustering_grid(points, tree, radius, min_points);
+
+                // 경계 근처 소유 점 + halo 점의 코어 여부 (타일 안 이웃은 실제 이웃의 부분집합이라 코어면 실제로도 코어)
+                //    패킷 탐색이 공간적으로 모이도록 트리 순서로 수집
+                std::vector<int> border, halo;
+                for (int i : tree.spatial_order())
+                {
+                    if (owner[i] != t)
+                        halo.push_back(i);
+                    else if (grid.near_border(points[i], t))
+                        border.push_back(i);
+                }
+
+                std::vector<int> checked(border);
+                checked.insert(checked.end(), halo.begin(), halo.end());
+                std::vector<int> counts(checked.size());
+                std::vector<char> is_core(n, 0);
+                parallel_for(0, checked.size(), 4096, [&](int begin, int end, int)
+                             {
+                                 Point3D targets[KDTREE_PACKET_SIZE];
+                                 for (int start = begin; start < end; start += KDTREE_PACKET_SIZE)
+                                 {
+                                     int c = std::min(end - start, KDTREE_PACKET_SIZE);
+                                     for (int q = 0; q < c; q++)
+                                         targets[q] = points[checked[start + q]];
+                                     tree.count_radius_packet(targets, c, radius, &counts[start]);
+                                     for (int q = 0; q < c; q++)
+                                         is_core[checked[start + q]] = counts[start + q] >= min_points;
+                                 }
+                             });
+
+                std::ofstream border_out(tile_file(tmp, "border", t), std::ios::binary);
+                for (int i : border)
+                {
+                    BorderPoint bp = {tile[i].id, labels[i], is_core[i]};
+                    border_out.write(reinterpret_cast<const char *>(&bp), sizeof(bp));
+                }
+
+                // halo 점마다 반경 안 코어 점(자신 포함)의 클러스터를 소유 타일로 전달
+                std::vector<std::vector<std::pair<int, HaloLink>>> links(worker_count()); // (소유 타일, 링크)
+                parallel_for(0, halo.size(), 4096, [&](int begin, int end, int thread_id)
+                             {
+                                 Point3D targets[KDTREE_PACKET_SIZE];
+                                 std::vector<int> neighbors[KDTREE_PACKET_SIZE];
+                                 std::vector<int> seen;
+                                 for (int start = begin; start < end; start += KDTREE_PACKET_SIZE)
+                                 {
+                                     int c = std::min(end - start, KDTREE_PACKET_SIZE);
+                                     for (int q = 0; q < c; q++)
+                                     {
+                                         targets[q] = points[halo[start + q]];
+                                         neighbors[q].clear();
+                                     }
+                                     tree.find_radius_packet(targets, c, radius, neighbors);
+
+                                     for (int q = 0; q < c; q++)
+                                     {
+                                         seen.clear();
+                                         for (int j : neighbors[q])
+                                         {
+                                             if (!is_core[j])
+                                                 continue;
+                                             if (std::find(seen.begin(), seen.end(), labels[j]) != seen.end())
+                                                 continue;
+
+                                             seen.push_back(labels[j]);
+                                             int h = halo[start + q];
+                                             links[thread_id].push_back({owner[h], {tile[h].id, t, labels[j]}});
+                                         }
+                                     }
+                                 }
+                             });
+
+                for (auto &thread_links : links)
+                {
+                    for (const auto &[owner, link] : thread_links)
+                    {
+                        halo_out.write(owner, &link, sizeof(link));
+                    }
+                }
+            }
+
+            // 소유 점 레이블 (파일 순서)
+            std::ofstream owned_out(tile_file(tmp, "owned", t), std::ios::binary);
+            int local_clusters = 0;
+            for (int i = 0; i < n; i++)
+            {
+                local_clusters = std::max(local_clusters, labels[i] + 1);
+                if (owner[i] == t)
+                    owned_out.write(reinterpret_cast<const char *>(&labels[i]), sizeof(int));
+            }
+            cluster_base[t + 1] = local_clusters;
+        }
+        task_hold_stage(false);
+    }
+    if (task_cancelled())
+    {
+        fs::remove_all(tmp, ec);
+        return false;
+    }
+
+    // 5. 전역 union-find: halo 점이 소유 타일에서 코어면 양쪽 클러스터 연결
+    //    소유 타일에서 노이즈인 점은 다른 타일 코어의 경계점 -> 그 클러스터로 배정
+    for (int t = 0; t < tile_count; t++)
+    {
+        cluster_base[t + 1] += cluster_base[t];
+    }
+    int total_clusters = cluster_base[tile_count];
+
+    std::vector<int> parent(total_clusters);
+    for (int c = 0; c < total_clusters; c++)
+    {
+        parent[c] = c;
+    }
+
+    //    경계점 배정은 타일마다 모아 파일로 내보냄 (전체 파일의 경계점을 메모리에 들고 있지 않도록)
+    for (int t = 0; t < tile_count; t++)
+    {
+        std::unordered_map<uint64_t, int> border_label; // 이 타일에서 노이즈였던 경계점 -> 전역 클러스터
+        std::unordered_map<uint64_t, BorderPoint> border;
+        for (const BorderPoint &bp : read_records<BorderPoint>(tile_file(tmp, "border", t)))
+        {
+            border[bp.id] = bp;
+        }
+
+        for (const HaloLink &link : read_records<HaloLink>(tile_file(tmp, "halo", t)))
+        {
+            auto it = border.find(link.id);
+            if (it == border.end())
+                continue;
+
+            int from = cluster_base[link.tile] + link.label;
+            if (it->second.core)
+            {
+                int a = find_root(parent, from);
+                int b = find_root(parent, cluster_base[t] + it->second.label);
+                if (a != b)
+                    parent[std::max(a, b)] = std::min(a, b);
+            }
+            else if (it->second.label == -1)
+            {
+                auto found = border_label.find(link.id);
+                if (found == border_label.end() || from < found->second)
+                    border_label[link.id] = from;
+            }
+        }
+
+        // 6에서 파일 순서로 읽으므로 id 순서로 저장
+        if (!border_label.empty())
+        {
+            std::vector<BorderAssign> assigned;
+            assigned.reserve(border_label.size());
+            for (const auto &entry : border_label)
+            {
+                assigned.push_back({entry.first, entry.second});
+            }
+            std::sort(assigned.begin(), assigned.end(), [](const BorderAssign &a, const BorderAssign &b)
+                      { return a.id < b.id; });
+
+            std::ofstream assign_out(tile_file(tmp, "assign", t), std::ios::binary);
+            assign_out.write(reinterpret_cast<const char *>(assigned.data()), assigned.size() * sizeof(BorderAssign));
+        }
+    }
+
+    // 6. 파일 순서로 최종 레이블 저장 (클러스터 번호는 처음 나온 순서)
+    std::ofstream label_out(label_path, std::ios::binary);
+    if (!label_out.is_open())
+    {
+        std::cerr << "파일 저장 실패: " << label_path << std::endl;
+        fs::remove_all(tmp, ec);
+        return false;
+    }
+
+    std::vector<int> compact(total_clusters, -1);
+    std::vector<long long> cluster_sizes;
+    {
+        TileReader<int> owned_in(tmp, "owned", tile_count, TILED_IO_BUFFER_BYTES);
+
+        // 타일별 다음 경계점 배정 (없으면 id = UINT64_MAX)
+        TileReader<BorderAssign> assign_in(tmp, "assign", tile_count, TILED_IO_BUFFER_BYTES);
+        std::vector<BorderAssign> next_assign(tile_count);
+        for (int t = 0; t < tile_count; t++)
+        {
+            if (grid.rects[t].child >= 0 || !assign_in.read(t, next_assign[t]))
+                next_assign[t].id = UINT64_MAX;
+        }
+
+        in.clear();
+        in.seekg(0);
+        uint64_t id = 0;
+        lines = 0;
+        task_begin_stage(file_bytes);
+        while (std::getline(in, line))
+        {
+            if (file_pass_cancelled(in, lines))
+            {
+                cancelled = true;
+                break;
+            }
+            if (!parse_vertex(line, p))
+                continue;
+
+            int leaf = grid.leaf_of(p);
+            int local = -1;
+            owned_in.read(leaf, local);
+
+            int global = -1;
+            if (local >= 0)
+            {
+                global = cluster_base[leaf] + local;
+            }
+            else if (next_assign[leaf].id == id)
+            {
+                global = next_assign[leaf].cluster;
+                if (!assign_in.read(leaf, next_assign[leaf]))
+                    next_assign[leaf].id = UINT64_MAX;
+            }
+
+            int label = -1;
+            if (global >= 0)
+            {
+                int root = find_root(parent, global);
+                if (compact[root] == -1)
+                {
+                    compact[root] = cluster_sizes.size();
+                    cluster_sizes.push_back(0);
+                }
+                label = compact[root];
+                cluster_sizes[label]++;
+            }
+
+            label_out.write(reinterpret_cast<const char *>(&label), sizeof(int));
+            id++;
+        }
+    }
+    label_out.close();
+    fs::remove_all(tmp, ec);
+    if (cancelled)
+    {
+        fs::remove(label_path, ec);
+        return false;
+    }
+
+    int largest = -1;
+    for (int c = 0; c < (int)cluster_sizes.size(); c++)
+    {
+        if (largest == -1 || cluster_sizes[c] > cluster_sizes[largest])
+            largest = c;
+    }
+
+    // 7. 가장 큰 클러스터의 정점 줄만 복사
+    if (!largest_path.empty() && largest >= 0)
+    {
+        std::ifstream label_in(label_path, std::ios::binary);
+        std::ofstream out(largest_path);
+        if (!out.is_open())
+        {
+            std::cerr << "파일 저장 실패: " << largest_path << std::endl;
+            return false;
+        }
+
+        in.clear();
+        in.seekg(0);
+        lines = 0;
+        task_begin_stage(file_bytes);
+        while (std::getline(in, line))
+        {
+            if (file_pass_cancelled(in, lines))
+            {
+                out.close();
+                fs::remove(largest_path, ec);
+                return false;
+            }
+            if (!parse_vertex(line, p))
+                continue;
+
+            int label = -1;
+            label_in.read(reinterpret_cast<char *>(&label), sizeof(int));
+            if (label == largest)
+                out << line << "\n";
+        }
+    }
+
+    if (stats)
+    {
+        stats->point_count = count;
+        stats->tile_count = leaf_count;
+        stats->max_tile_points = max_tile_points;
+        stats->cluster_count = cluster_sizes.size();
+        stats->largest_cluster = largest >= 0 ? cluster_sizes[largest] : 0;
+    }
+
+    std::cout << "타일 DBSCAN 완료! 총 " << cluster_sizes.size() << "개 클러스터, 최대 타일 "
+              << max_tile_points << "개 점" << std::endl;
+
+    return true;
+}
@@ -0,0 +1,44 @@
+#ifndef TILED_DBSCAN_H
+#define TILED_DBSCAN_H
+
+#include <cstddef>
+#include <string>
+
+// 타일 한 개를 처리할 때 점 하나당 예상 메모리 (점 + 트리 노드 + 격자 정렬 + 레이블, 실측 기준)
+const size_t TILED_BYTES_PER_POINT = 256;
+
+// 타일 크기 결정용 표본 점 수 (첫 번째 읽기에서 reservoir sampling)
+const int TILED_SAMPLE_SIZE = 65536;
+
+// 타일별 임시 파일 쓰기/읽기 버퍼 전체 크기 (파일을 계속 열어 두지 않으므로 타일 수에는 제한이 없음)
+const size_t TILED_IO_BUFFER_BYTES = 32 * 1024 * 1024;
+
+// 타일 DBSCAN 통계
+struct TiledDbscanStats
+{
+    long long point_count = 0;     // 전체 정점 수
+    int tile_count = 0;            // 타일 수 (나눈 타일은 잎 타일만)
+    long long max_tile_points = 0; // 가장 큰 타일의 점 수 (halo 포함)
+    int cluster_count = 0;         // 병합 후 클러스터 수
+    long long largest_cluster = 0; // 가장 큰 클러스터의 점 수
+};
+
+// 메모리에 다 올릴 수 없는 OBJ 파일용 DBSCAN (파일에서 스트리밍)
+// 1. XZ 평면을 타일로 나누고 각 점을 자기 타일 + radius 폭 halo에 해당하는 이웃 타일의 임시 파일로 분배
+// 2. 타일을 하나씩 읽어 격자 DBSCAN (표본으로 타일별 점 수를 추정해 memory_budget_mb 안에 들도록 타일 수 결정,
+//    분배 후에도 예산을 넘는 타일은 긴 축으로 반씩 나눔)
+// 3. 타일 경계를 넘는 코어 점 연결을 전역 union-find로 병합
+// 4. label_path에 정점 순서대로 int32 레이블 (-1: 노이즈) 저장
+//    largest_path가 비어 있지 않으면 가장 큰 클러스터의 정점만 OBJ로 저장 (면은 저장하지 않음)
+// 메모리 사용량은 점 개수와 무관하게 타일 하나 + 클러스터 수에 비례
+// 백그라운드 작업이면 단계별 진행률(파일 위치, 타일 수)을 올리고, 취소되면 임시/결과 파일을 지우고 false
+bool dbscan_clustering_tiled(
+    const std::string &obj_path,
+    const std::string &label_path,
+    const std::string &largest_path,
+    float radius,
+    int min_points,
+    size_t memory_budget_mb,
+    TiledDbscanStats *stats = nullptr);
+
+#endif // TILED_DBSCAN_H